@@ -0,0 +1,78 @@
+#include "../logs/mylog.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace mylog;
+
+// 落地偶尔卡顿：每写满约 4MB 停 20ms，模拟磁盘抖动
+class StallSink : public LogSink
+{
+public:
+    virtual void log(const char *, size_t len) override { account(len); }
+    virtual void logBatch(const char *, size_t len, const SinkRecord *, size_t) override { account(len); }
+
+private:
+    void account(size_t len)
+    {
+        _bytes += len;
+        if (_bytes >= 4 * 1024 * 1024)
+        {
+            _bytes = 0;
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        }
+    }
+    size_t _bytes = 0;
+};
+
+// 生产者按固定节奏写（每 64 条让出一次），统计单次调用耗时：双缓冲在落地卡顿时很快写满而阻塞，多缓冲池用预算吸收抖动
+void run(const std::string &name, void (*config)(LoggerBuilder &))
+{
+    const size_t count = 1000000;
+    const std::string msg(199, 'x');
+
+    LocalLoggerBuilder builder;
+    builder.buildLoggerName(name);
+    builder.buildLoggerFormatter("%m%n");
+    builder.buildLoggerType(LoggerType::LOGGER_ASYNC);
+    builder.buildLoggerSink<StallSink>();
+    config(builder);
+    Logger::ptr lp = builder.build();
+
+    std::vector<double> lat;
+    lat.reserve(count);
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < count; i++)
+    {
+        auto t0 = std::chrono::steady_clock::now();
+        LOG_INFO(lp, "%s", msg.c_str());
+        auto t1 = std::chrono::steady_clock::now();
+        lat.push_back(std::chrono::duration<double, std::micro>(t1 - t0).count());
+        if (i % 64 == 0)
+            std::this_thread::yield();
+    }
+    double total_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    size_t blocked = std::count_if(lat.begin(), lat.end(), [](double us)
+                                   { return us > 1000; });
+    std::sort(lat.begin(), lat.end());
+    auto pct = [&](double p)
+    { return lat[static_cast<size_t>(p * (lat.size() - 1))]; };
+    std::cout << name << "\t总耗时: " << total_ms << "ms\tp99: " << pct(0.99) << "us\tp99.9: " << pct(0.999)
+              << "us\tp99.99: " << pct(0.9999) << "us\tmax: " << lat.back() << "us\t>1ms 次数: " << blocked << "\n";
+}
+
+int main()
+{
+    run("double 4MB   ", [](LoggerBuilder &b)
+        { b.buildAsyncBufferMax(4 * 1024 * 1024); });
+    run("pool 4MBx16  ", [](LoggerBuilder &b)
+        { b.buildAsyncBufferPool(4 * 1024 * 1024, 64 * 1024 * 1024); });
+    run("double 64MB  ", [](LoggerBuilder &b)
+        { b.buildAsyncBufferMax(64 * 1024 * 1024); });
+    return 0;
+}
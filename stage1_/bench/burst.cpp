@@ -0,0 +1,82 @@
+#include "../logs/mylog.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace mylog;
+
+// 突发写入基准：后台落地在突发结束前一直卡住，生产缓冲区只能一路扩容到 100MB，
+// 统计每次写日志调用的耗时分布，观察扩容造成的生产者停顿
+static std::atomic<bool> g_open{false};
+
+class GateSink : public LogSink
+{
+public:
+    virtual void log(const char *, size_t) override { wait(); }
+    virtual void logBatch(const char *, size_t, const SinkRecord *, size_t) override { wait(); }
+
+private:
+    void wait()
+    {
+        while (!g_open.load())
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+};
+
+void burst(const std::string &name, void (*config)(LoggerBuilder &))
+{
+    const size_t total = 100 * 1024 * 1024, msglen = 200;
+    const std::string msg(msglen - 1, 'x');
+    g_open.store(false);
+
+    LocalLoggerBuilder builder;
+    builder.buildLoggerName(name);
+    builder.buildLoggerFormatter("%m%n");
+    builder.buildLoggerType(LoggerType::LOGGER_ASYNC);
+    builder.buildLoggerSink<GateSink>();
+    builder.buildAsyncBufferMax(256 * 1024 * 1024);
+    if (config)
+        config(builder);
+    auto create_start = std::chrono::steady_clock::now();
+    Logger::ptr lp = builder.build();
+    double create_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - create_start).count();
+
+    std::vector<double> lat;
+    lat.reserve(total / msglen + 1);
+    auto start = std::chrono::steady_clock::now();
+    for (size_t written = 0; written < total; written += msglen)
+    {
+        auto t0 = std::chrono::steady_clock::now();
+        LOG_INFO(lp, "%s", msg.c_str());
+        auto t1 = std::chrono::steady_clock::now();
+        lat.push_back(std::chrono::duration<double, std::micro>(t1 - t0).count());
+    }
+    double total_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    g_open.store(true);
+
+    size_t stalls = std::count_if(lat.begin(), lat.end(), [](double us)
+                                  { return us > 1000; });
+    std::sort(lat.begin(), lat.end());
+    auto pct = [&](double p)
+    { return lat[static_cast<size_t>(p * (lat.size() - 1))]; };
+    std::cout << name << "\t创建: " << create_ms << "ms\t总耗时: " << total_ms << "ms\tp50: " << pct(0.5)
+              << "us\tp99: " << pct(0.99) << "us\tp99.9: " << pct(0.999) << "us\tmax: " << lat.back()
+              << "us\t>1ms 次数: " << stalls << "\n";
+}
+
+int main()
+{
+    burst("default ", nullptr);
+    burst("hugepage", [](LoggerBuilder &b)
+          { b.buildAsyncBufferStorage(true); });
+    burst("prefault", [](LoggerBuilder &b)
+          { b.buildAsyncBufferStorage(false, 128 * 1024 * 1024); });
+    burst("huge+pre", [](LoggerBuilder &b)
+          { b.buildAsyncBufferStorage(true, 128 * 1024 * 1024); });
+    return 0;
+}
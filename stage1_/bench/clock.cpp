@@ -0,0 +1,54 @@
+#include "../logs/util.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <string>
+
+using namespace mylog;
+
+// 对比各时钟源的单次调用耗时与可观测到的最小时间步长
+template <typename F>
+void clock_bench(const std::string &name, F now, size_t count)
+{
+    volatile uint64_t sink = 0;
+    uint64_t min_step = UINT64_MAX;
+    uint64_t last = now();
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < count; i++)
+    {
+        uint64_t cur = now();
+        if (cur > last && cur - last < min_step)
+            min_step = cur - last;
+        last = cur;
+        sink = sink + cur;
+    }
+    auto end = std::chrono::steady_clock::now();
+    double ns = std::chrono::duration<double, std::nano>(end - start).count() / count;
+    std::cout << name << "\t每次调用: " << ns << "ns\t最小步长: ";
+    if (min_step == UINT64_MAX)
+        std::cout << "(测试期间未跳变)\n";
+    else
+        std::cout << min_step << "ns\n";
+}
+
+int main()
+{
+    const size_t count = 10000000;
+    util::Date::setClockSource(util::ClockSource::TSC); // 先完成 TSC 校准，不计入耗时
+    clock_bench("time(nullptr)", []
+                { return static_cast<uint64_t>(util::Date::now()) * 1000000000ull; }, count);
+    clock_bench("COARSE ", []
+                { return util::Date::coarseNs(); }, count);
+    clock_bench("PRECISE", []
+                { return util::Date::preciseNs(); }, count);
+    clock_bench("TSC    ", []
+                { return util::Date::tscNs(); }, count);
+    clock_bench("nowNs(TSC)", []
+                { return util::Date::nowNs(); }, count);
+
+    // TSC 与系统时钟的偏差
+    int64_t drift = static_cast<int64_t>(util::Date::tscNs()) - static_cast<int64_t>(util::Date::preciseNs());
+    std::cout << "TSC 与 CLOCK_REALTIME 偏差: " << drift << "ns\n";
+    return 0;
+}
@@ -0,0 +1,71 @@
+#include "../logs/mylog.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace mylog;
+
+// 定时刷新的吞吐代价：同样写 200 万条到文件，对比不刷新与每 10ms/100ms/1s 刷新一次
+static std::atomic<size_t> g_flushes{0};
+
+class CountingFileSink : public FileSink
+{
+public:
+    using FileSink::FileSink;
+    virtual void flush() override
+    {
+        g_flushes++;
+        FileSink::flush();
+    }
+};
+
+void run(const std::string &name, LoggerType type, std::chrono::milliseconds interval)
+{
+    const size_t threads = 2, count = 2000000;
+    const std::string path = "./logfile/flush_every.log";
+    std::remove(path.c_str());
+    g_flushes = 0;
+
+    LocalLoggerBuilder builder;
+    builder.buildLoggerName(name);
+    builder.buildLoggerFormatter("[%d{%H:%M:%S.%3N}][%t][%p] %m%n");
+    builder.buildLoggerType(type);
+    builder.buildLoggerSink<CountingFileSink>(path);
+    builder.buildLoggerFlushEvery(interval);
+    Logger::ptr lp = builder.build();
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> ths;
+    for (size_t t = 0; t < threads; t++)
+    {
+        ths.emplace_back([&]
+                         {
+            for (size_t i = 0; i < count / threads; i++)
+                LOG_INFO(lp, "flush every bench message %zu with some payload", i); });
+    }
+    for (auto &th : ths)
+        th.join();
+    lp->flush(); // 计入把数据全部落到系统的时间
+    double cost = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << name << "\t耗时: " << cost << "s\t每秒: " << static_cast<size_t>(count / cost)
+              << " 条\t刷新次数: " << g_flushes.load() << "\n";
+}
+
+int main()
+{
+    const std::pair<const char *, std::chrono::milliseconds> intervals[] = {
+        {"off  ", std::chrono::milliseconds(0)},
+        {"10ms ", std::chrono::milliseconds(10)},
+        {"100ms", std::chrono::milliseconds(100)},
+        {"1s   ", std::chrono::milliseconds(1000)}};
+    for (auto &it : intervals)
+        run(std::string("sync  ") + it.first, LoggerType::LOGGER_SYNC, it.second);
+    for (auto &it : intervals)
+        run(std::string("async ") + it.first, LoggerType::LOGGER_ASYNC, it.second);
+    return 0;
+}
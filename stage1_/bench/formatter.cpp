@@ -0,0 +1,125 @@
+#include "../logs/format.hpp"
+
+#include <chrono>
+#include <ctime>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace mylog;
+
+static constexpr char kDefaultPattern[] = "[%d{%H:%M:%S}][%t][%c][%f:%l][%p]%T%m%n";
+
+// 改造前的做法：虚函数 FormatItem 逐项写入 stringstream，再拷贝出 std::string（库里已删除，这里保留一份作对照）
+namespace legacy
+{
+    struct FormatItem
+    {
+        using ptr = std::shared_ptr<FormatItem>;
+        virtual ~FormatItem() = default;
+        virtual void format(std::ostream &out, const LogMsg &msg) = 0;
+    };
+    struct Text : FormatItem
+    {
+        explicit Text(std::string s) : str(std::move(s)) {}
+        void format(std::ostream &out, const LogMsg &) override { out << str; }
+        std::string str;
+    };
+    struct Time : FormatItem
+    {
+        void format(std::ostream &out, const LogMsg &msg) override
+        {
+            struct tm t;
+            time_t ts = msg.getCtime();
+            localtime_r(&ts, &t);
+            char tmp[64] = {0};
+            strftime(tmp, 31, "%H:%M:%S", &t);
+            out << tmp;
+        }
+    };
+    struct Thread : FormatItem
+    {
+        void format(std::ostream &out, const LogMsg &msg) override { out << msg.getTid(); }
+    };
+    struct Logger : FormatItem
+    {
+        void format(std::ostream &out, const LogMsg &msg) override { out << msg.getLogger(); }
+    };
+    struct File : FormatItem
+    {
+        void format(std::ostream &out, const LogMsg &msg) override { out << msg.getFile(); }
+    };
+    struct Line : FormatItem
+    {
+        void format(std::ostream &out, const LogMsg &msg) override { out << msg.getLine(); }
+    };
+    struct Level : FormatItem
+    {
+        void format(std::ostream &out, const LogMsg &msg) override { out << LogLevel::toString(msg.getLevel()); }
+    };
+    struct Msg : FormatItem
+    {
+        void format(std::ostream &out, const LogMsg &msg) override { out << msg.getPayload(); }
+    };
+
+    // 对应 "[%d{%H:%M:%S}][%t][%c][%f:%l][%p]%T%m%n"
+    static std::vector<FormatItem::ptr> items()
+    {
+        return {std::make_shared<Text>("["), std::make_shared<Time>(),
+                std::make_shared<Text>("]["), std::make_shared<Thread>(),
+                std::make_shared<Text>("]["), std::make_shared<Logger>(),
+                std::make_shared<Text>("]["), std::make_shared<File>(),
+                std::make_shared<Text>(":"), std::make_shared<Line>(),
+                std::make_shared<Text>("]["), std::make_shared<Level>(),
+                std::make_shared<Text>("]\t"), std::make_shared<Msg>(), std::make_shared<Text>("\r\n")};
+    }
+}
+
+template <typename F>
+void format_bench(const std::string &name, F fn, size_t count)
+{
+    size_t bytes = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < count; i++)
+        bytes += fn();
+    auto end = std::chrono::steady_clock::now();
+    double cost = std::chrono::duration<double>(end - start).count();
+    std::cout << name << "\t耗时: " << cost << "s\t平均: " << (size_t)(count / cost) << "条/s\t"
+              << cost * 1e9 / count << "ns/条\t(" << bytes / count << "B/条)\n";
+}
+
+int main()
+{
+    const size_t count = 2000000;
+    std::string logger = "bench", file = "formatter.cpp";
+    LogMsg msg(logger, file, 42, std::string(100, '1'), LogLevel::value::INFO);
+    msg.setTidToCurrent();
+
+    auto items = legacy::items();
+    format_bench("虚函数+stringstream", [&]
+                 {
+        std::stringstream ss;
+        for (auto &item : items)
+            item->format(ss, msg);
+        std::string str = ss.str();
+        return str.size(); }, count);
+
+    Formatter fmt;
+    std::string out;
+    format_bench("指令序列+复用缓冲", [&]
+                 {
+        out.clear();
+        fmt.format(out, msg);
+        return out.size(); }, count);
+
+    StaticFormatter<kDefaultPattern> sfmt;
+    format_bench("编译期模式串\t", [&]
+                 {
+        out.clear();
+        sfmt.format(out, msg);
+        return out.size(); }, count);
+    return 0;
+}
@@ -8,10 +8,10 @@ void sync_bench_thread_log(size_t thread_count, size_t msg_count, size_t msglen)
     static int num = 1;
     std::string logger_name = "sync_bench_logger" + std::to_string(num++);
     LOGI("************************************************");
-    LOGI("同步日志测试: %d threads, %d messages", thread_count, msg_count);
+    LOGI("同步日志测试: %zu threads, %zu messages", thread_count, msg_count);
 
     GlobalLoggerBuilder::ptr lbp(new GlobalLoggerBuilder);
-    lbp->buildAsyncBufferMax(1024 * 1024 * 1024 * 1024);
+    lbp->buildAsyncBufferMax(1024ULL * 1024 * 1024 * 1024);
     lbp->buildLoggerName(logger_name);
     lbp->buildLoggerFormatter("%m");
     lbp->buildLoggerSink<FileSink>("./logs/sync.log");
@@ -25,16 +25,127 @@ void async_bench_thread_log(size_t thread_count, size_t msg_count, size_t msglen
     static int num = 1;
     std::string logger_name = "async_bench_logger" + std::to_string(num++);
     LOGI("************************************************");
-    LOGI("异步日志测试: %d threads, %d messages", thread_count, msg_count);
+    LOGI("异步日志测试: %zu threads, %zu messages", thread_count, msg_count);
 
     GlobalLoggerBuilder::ptr lbp(new GlobalLoggerBuilder);
-    lbp->buildAsyncBufferMax(1024 * 1024 * 1024 * 1024);
+    lbp->buildAsyncBufferMax(1024ULL * 1024 * 1024 * 1024);
     lbp->buildLoggerName(logger_name);
     lbp->buildLoggerFormatter("%m");
     lbp->buildLoggerSink<FileSink>("./logs/async.log");
     lbp->buildLoggerType(LoggerType::LOGGER_ASYNC);
     lbp->build();
     bench(logger_name, thread_count, msglen, msg_count);
+    // 异步写入只统计生产者耗时，这里把落地也算上
+    auto start = std::chrono::high_resolution_clock::now();
+    getLogger(logger_name)->flush();
+    std::chrono::duration<double> drain = std::chrono::high_resolution_clock::now() - start;
+    std::cout << "等待落地完成: " << drain.count() << "s" << std::endl;
+    LOGI("************************************************");
+}
+void sync_fd_bench_thread_log(size_t thread_count, size_t msg_count, size_t msglen)
+{
+    static int num = 1;
+    std::string logger_name = "sync_fd_bench_logger" + std::to_string(num++);
+    LOGI("************************************************");
+    LOGI("同步日志测试（FdFileSink）: %zu threads, %zu messages", thread_count, msg_count);
+
+    GlobalLoggerBuilder::ptr lbp(new GlobalLoggerBuilder);
+    lbp->buildLoggerName(logger_name);
+    lbp->buildLoggerFormatter("%m");
+    lbp->buildLoggerSink<FdFileSink>("./logs/sync_fd.log");
+    lbp->buildLoggerType(LoggerType::LOGGER_SYNC);
+    lbp->build();
+    bench(logger_name, thread_count, msglen, msg_count);
+    LOGI("************************************************");
+}
+void async_fd_bench_thread_log(size_t thread_count, size_t msg_count, size_t msglen)
+{
+    static int num = 1;
+    std::string logger_name = "async_fd_bench_logger" + std::to_string(num++);
+    LOGI("************************************************");
+    LOGI("异步日志测试（FdFileSink）: %zu threads, %zu messages", thread_count, msg_count);
+
+    GlobalLoggerBuilder::ptr lbp(new GlobalLoggerBuilder);
+    lbp->buildAsyncBufferMax(1024ULL * 1024 * 1024 * 1024);
+    lbp->buildLoggerName(logger_name);
+    lbp->buildLoggerFormatter("%m");
+    lbp->buildLoggerSink<FdFileSink>("./logs/async_fd.log");
+    lbp->buildLoggerType(LoggerType::LOGGER_ASYNC);
+    lbp->build();
+    bench(logger_name, thread_count, msglen, msg_count);
+    // 异步写入只统计生产者耗时，这里把落地也算上
+    auto start = std::chrono::high_resolution_clock::now();
+    getLogger(logger_name)->flush();
+    std::chrono::duration<double> drain = std::chrono::high_resolution_clock::now() - start;
+    std::cout << "等待落地完成: " << drain.count() << "s" << std::endl;
+    LOGI("************************************************");
+}
+void async_deferred_bench_thread_log(size_t thread_count, size_t msg_count, size_t msglen)
+{
+    static int num = 1;
+    std::string logger_name = "async_deferred_bench_logger" + std::to_string(num++);
+    LOGI("************************************************");
+    LOGI("异步延迟格式化测试: %zu threads, %zu messages", thread_count, msg_count);
+
+    GlobalLoggerBuilder::ptr lbp(new GlobalLoggerBuilder);
+    lbp->buildLoggerName(logger_name);
+    lbp->buildLoggerFormatter("%m");
+    lbp->buildLoggerSink<FileSink>("./logs/async_deferred.log");
+    lbp->buildLoggerType(LoggerType::LOGGER_ASYNC);
+    lbp->buildAsyncDeferred();
+    lbp->build();
+    bench(logger_name, thread_count, msglen, msg_count);
+    LOGI("************************************************");
+}
+void async_ring_bench_thread_log(size_t thread_count, size_t msg_count, size_t msglen)
+{
+    static int num = 1;
+    std::string logger_name = "async_ring_bench_logger" + std::to_string(num++);
+    LOGI("************************************************");
+    LOGI("异步无锁环测试: %zu threads, %zu messages", thread_count, msg_count);
+
+    GlobalLoggerBuilder::ptr lbp(new GlobalLoggerBuilder);
+    lbp->buildLoggerName(logger_name);
+    lbp->buildLoggerFormatter("%m");
+    lbp->buildLoggerSink<FileSink>("./logs/async_ring.log");
+    lbp->buildLoggerType(LoggerType::LOGGER_ASYNC);
+    lbp->buildAsyncLooperType(LooperType::LOOPER_RING, 64 * 1024 * 1024);
+    lbp->build();
+    bench(logger_name, thread_count, msglen, msg_count);
+    LOGI("************************************************");
+}
+void async_per_thread_bench_thread_log(size_t thread_count, size_t msg_count, size_t msglen)
+{
+    static int num = 1;
+    std::string logger_name = "async_per_thread_bench_logger" + std::to_string(num++);
+    LOGI("************************************************");
+    LOGI("异步每线程队列测试: %zu threads, %zu messages", thread_count, msg_count);
+
+    GlobalLoggerBuilder::ptr lbp(new GlobalLoggerBuilder);
+    lbp->buildLoggerName(logger_name);
+    lbp->buildLoggerFormatter("%m");
+    lbp->buildLoggerSink<FileSink>("./logs/async_per_thread.log");
+    lbp->buildLoggerType(LoggerType::LOGGER_ASYNC);
+    lbp->buildAsyncLooperType(LooperType::LOOPER_PER_THREAD, 8 * 1024 * 1024);
+    lbp->build();
+    bench(logger_name, thread_count, msglen, msg_count);
+    LOGI("************************************************");
+}
+void async_pool_bench_thread_log(size_t thread_count, size_t msg_count, size_t msglen)
+{
+    static int num = 1;
+    std::string logger_name = "async_pool_bench_logger" + std::to_string(num++);
+    LOGI("************************************************");
+    LOGI("异步共享线程池测试: %zu threads, %zu messages", thread_count, msg_count);
+
+    GlobalLoggerBuilder::ptr lbp(new GlobalLoggerBuilder);
+    lbp->buildLoggerName(logger_name);
+    lbp->buildLoggerFormatter("%m");
+    lbp->buildLoggerSink<FileSink>("./logs/async_pool.log");
+    lbp->buildLoggerType(LoggerType::LOGGER_ASYNC);
+    lbp->buildAsyncSharedPool(2);
+    lbp->build();
+    bench(logger_name, thread_count, msglen, msg_count);
     LOGI("************************************************");
 }
 void bench_test()
@@ -42,9 +153,29 @@ void bench_test()
     /*异步日志输出*/
     async_bench_thread_log(1, 1000000, 100);
     async_bench_thread_log(5, 1000000, 100);
+    async_bench_thread_log(8, 1000000, 100);
+    // 异步 + 无锁环
+    async_ring_bench_thread_log(1, 1000000, 100);
+    async_ring_bench_thread_log(5, 1000000, 100);
+    async_ring_bench_thread_log(8, 1000000, 100);
+    // 异步 + 每线程队列
+    async_per_thread_bench_thread_log(1, 1000000, 100);
+    async_per_thread_bench_thread_log(5, 1000000, 100);
+    async_per_thread_bench_thread_log(8, 1000000, 100);
+    // 异步 + 共享线程池
+    async_pool_bench_thread_log(1, 1000000, 100);
+    async_pool_bench_thread_log(5, 1000000, 100);
+    // 异步 + 延迟格式化
+    async_deferred_bench_thread_log(1, 1000000, 100);
+    async_deferred_bench_thread_log(5, 1000000, 100);
     // 同步写日志
     sync_bench_thread_log(1, 1000000, 100);
     sync_bench_thread_log(5, 1000000, 100);
+    // POSIX 文件落地（open + 自带缓冲 + writev）
+    async_fd_bench_thread_log(1, 1000000, 100);
+    async_fd_bench_thread_log(5, 1000000, 100);
+    sync_fd_bench_thread_log(1, 1000000, 100);
+    sync_fd_bench_thread_log(5, 1000000, 100);
 }
 
 int main(int argc, char *argv[])
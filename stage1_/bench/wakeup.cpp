@@ -0,0 +1,88 @@
+#include "../logs/mylog.h"
+
+#include <sys/resource.h>
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace mylog;
+
+// 只计数不落地，把开销集中在生产者与唤醒路径上
+class NullSink : public LogSink
+{
+public:
+    virtual void log(const char *data, size_t len) override
+    {
+        (void)data;
+        (void)len;
+    }
+};
+
+static long voluntarySwitches()
+{
+    struct rusage ru;
+    getrusage(RUSAGE_SELF, &ru);
+    return ru.ru_nvcsw;
+}
+
+// burst > 0 时每写 burst 条休眠 100us，模拟消费者经常追上、反复入睡的场景
+void wakeup_bench(const std::string &name, const AsyncOptions &opts, size_t thread_count, size_t msg_count, size_t burst)
+{
+    std::vector<LogSink::ptr> sinks{std::make_shared<NullSink>()};
+    size_t wakeups = 0;
+    long switches = voluntarySwitches();
+    auto start = std::chrono::steady_clock::now();
+    {
+        auto lp = std::make_shared<AsyncLogger>(name, LogLevel::value::DEBUG, std::make_shared<Formatter>("%m%n"), sinks, opts);
+        std::vector<std::thread> threads;
+        for (size_t t = 0; t < thread_count; t++)
+        {
+            threads.emplace_back([&]
+                                 {
+                for (size_t i = 0; i < msg_count / thread_count; i++)
+                {
+                    LOG_INFO(lp, "wakeup bench message %zu", i);
+                    if (burst && i % burst == burst - 1)
+                        std::this_thread::sleep_for(std::chrono::microseconds(100));
+                } });
+        }
+        for (auto &th : threads)
+            th.join();
+        wakeups = lp->wakeups();
+    }
+    double cost = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    switches = voluntarySwitches() - switches;
+    std::cout << name << "\t线程: " << thread_count << "\t耗时: " << cost << "s"
+              << "\t唤醒/条: " << (double)wakeups / msg_count
+              << "\t主动上下文切换/条: " << (double)switches / msg_count << "\n";
+}
+
+int main()
+{
+    const size_t count = 1000000;
+    AsyncOptions every;
+    every.wakeup.every_push = true; // 改造前：每条都 notify_one
+    AsyncOptions plain;
+    AsyncOptions batched;
+    batched.wakeup.bytes = 64 * 1024;
+    batched.wakeup.count = 1024;
+    batched.wakeup.max_latency = std::chrono::milliseconds(10);
+    AsyncOptions ring;
+    ring.looper = LooperType::LOOPER_RING;
+
+    for (size_t burst : {size_t(0), size_t(100)})
+    {
+        std::cout << (burst ? "---- 突发写入（每 100 条休眠 100us）----\n" : "---- 连续写入 ----\n");
+        for (size_t threads : {size_t(1), size_t(4)})
+        {
+            wakeup_bench("mutex(旧)  ", every, threads, burst ? count / 10 : count, burst);
+            wakeup_bench("mutex      ", plain, threads, burst ? count / 10 : count, burst);
+            wakeup_bench("mutex+batch", batched, threads, burst ? count / 10 : count, burst);
+            wakeup_bench("ring       ", ring, threads, burst ? count / 10 : count, burst);
+        }
+    }
+    return 0;
+}
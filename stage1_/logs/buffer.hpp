@@ -6,6 +6,9 @@
 #include <cstring>
 #include <algorithm>
 #include <cassert>
+#include <new>
+#include <sys/mman.h>
+#include <unistd.h>
 
 namespace mylog
 {
@@ -14,13 +17,122 @@ namespace mylog
     inline constexpr size_t INCREMENT_BUFFER_SIZE = 10 * 1024 * 1024;
     // inline constexpr size_t MAX_BUFFER_SIZE = 200 * 1024 * 1024;
 
+    // 缓冲区存储的可选项：由日志器创建时传入
+    struct StorageConfig
+    {
+        bool huge_pages = false; // 对映射区域建议使用透明大页（MADV_HUGEPAGE）
+        size_t prefault = 0;     // 创建时就分配并触碰的字节数，把缺页开销挪到日志器创建阶段
+    };
+
+    /*缓冲区的底层存储：匿名 mmap 映射
+        1.不做零填充：新页由内核在第一次写入时提供，没写过的部分不占物理内存
+        2.扩容用 mremap 重新映射，已有数据不拷贝（只移动页表）
+        3.接口与 std::vector<char> 的 data/size/resize/swap 保持一致
+    */
+    class BufferStorage
+    {
+    public:
+        explicit BufferStorage(size_t size, const StorageConfig &config = StorageConfig())
+            : _huge_pages(config.huge_pages)
+        {
+            resize(std::max(size, config.prefault));
+            if (config.prefault)
+                prefault(config.prefault);
+        }
+        ~BufferStorage()
+        {
+            if (_data)
+                ::munmap(_data, _mapped);
+        }
+        BufferStorage(const BufferStorage &) = delete;
+        BufferStorage &operator=(const BufferStorage &) = delete;
+
+        char *data() { return _data; }
+        const char *data() const { return _data; }
+        size_t size() const { return _size; }
+
+        // 只增不减：超出已映射的部分时按页重新映射，原有内容保持不变
+        void resize(size_t size)
+        {
+            if (size <= _mapped)
+            {
+                _size = std::max(_size, size);
+                return;
+            }
+            size_t mapped = roundPage(size);
+            void *p;
+            if (_data)
+                p = ::mremap(_data, _mapped, mapped, MREMAP_MAYMOVE);
+            else
+                p = ::mmap(nullptr, mapped, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+            if (p == MAP_FAILED)
+                throw std::bad_alloc();
+            _data = static_cast<char *>(p);
+            _mapped = mapped;
+            _size = size;
+            if (_huge_pages)
+                ::madvise(_data, _mapped, MADV_HUGEPAGE); // 建议而已，内核不支持时忽略
+        }
+
+        // 收缩到 size 字节，多余的整页直接解除映射归还给系统
+        void shrink(size_t size)
+        {
+            size_t mapped = roundPage(size);
+            if (mapped < _mapped)
+            {
+                ::munmap(_data + mapped, _mapped - mapped);
+                _mapped = mapped;
+            }
+            _size = std::min(_size, size);
+        }
+
+        // 预先触碰前 len 字节对应的页
+        void prefault(size_t len)
+        {
+            len = std::min(len, _mapped);
+#ifdef MADV_POPULATE_WRITE
+            if (::madvise(_data, len, MADV_POPULATE_WRITE) == 0)
+                return;
+#endif
+            const size_t page = pageSize();
+            for (size_t off = 0; off < len; off += page)
+                reinterpret_cast<volatile char *>(_data)[off] = 0;
+        }
+
+        void swap(BufferStorage &other)
+        {
+            std::swap(_data, other._data);
+            std::swap(_size, other._size);
+            std::swap(_mapped, other._mapped);
+            std::swap(_huge_pages, other._huge_pages);
+        }
+
+    private:
+        static size_t pageSize()
+        {
+            static const size_t page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+            return page;
+        }
+        static size_t roundPage(size_t n)
+        {
+            const size_t page = pageSize();
+            return (std::max<size_t>(n, 1) + page - 1) / page * page;
+        }
+
+        char *_data = nullptr;
+        size_t _size = 0;   // 对外可用的字节数
+        size_t _mapped = 0; // 实际映射的字节数（页对齐）
+        bool _huge_pages;
+    };
+
     class Buffer
     {
     public:
         // 修改：1.0只声明了 Buffer();，没有定义，成员未初始化会 UB
-        Buffer(size_t max_size = 200 * 1024 * 1024)
+        Buffer(size_t max_size = 200 * 1024 * 1024, size_t initial_size = DEFAULT_BUFFER_SIZE,
+               const StorageConfig &storage = StorageConfig())
             : _MAX_BUFFER_SIZE(max_size),
-              _buffer(std::min(DEFAULT_BUFFER_SIZE, _MAX_BUFFER_SIZE)), // ← 改：初始容量不超过 MAX
+              _buffer(std::max<size_t>(1, std::min(initial_size, _MAX_BUFFER_SIZE)), storage), // ← 改：初始容量不超过 MAX
               _reader_idx(0),
               _writer_idx(0)
         {
@@ -39,7 +151,8 @@ namespace mylog
             // 1.固定大小，则直接返回
             // 2.动态空间，用于极限测试--扩容
             ensureEnoughSize(len);
-            if (writerableSize() < len)
+            // 已分配的空间可能大于后来调小的上限，写入量仍以上限为准
+            if (writerableSize() < len || _writer_idx + len > _MAX_BUFFER_SIZE)
             {
                 return false;
             }
@@ -50,6 +163,21 @@ namespace mylog
             moveWriter(len);
             return true;
         };
+        // 就地写入：预留至少 n 字节的连续可写空间并返回起始地址，放不下（受上限约束）返回 nullptr；
+        // 调用方直接写入后再 commit 实际写入的字节数（不超过 n），未 commit 的部分视为没写
+        char *reserve(size_t n)
+        {
+            ensureEnoughSize(n);
+            if (writerableSize() < n || _writer_idx + n > _MAX_BUFFER_SIZE)
+            {
+                return nullptr;
+            }
+            return _buffer.data() + _writer_idx;
+        }
+        void commit(size_t len)
+        {
+            moveWriter(len);
+        }
         size_t writerableSize() const
         {
             // 仅针对固定大小缓冲区提供，因为可扩容缓冲区总是可写
@@ -85,6 +213,28 @@ namespace mylog
             assert(_reader_idx <= _writer_idx);
             assert(_writer_idx <= _buffer.size());
         };
+        // 丢弃头部 len 字节，并把剩余数据搬到缓冲区开头，使空出的空间可以继续写入
+        void discardFront(size_t len)
+        {
+            assert(len <= readableSize());
+            size_t remain = readableSize() - len;
+            if (remain)
+                std::memmove(_buffer.data(), readPtr() + len, remain);
+            _reader_idx = 0;
+            _writer_idx = remain;
+        };
+        // 当前已分配的容量
+        size_t capacity() const
+        {
+            return _buffer.size();
+        };
+        // 把容量收缩到 cap（不会小于已写入的数据），多出来的内存归还给系统
+        void shrinkTo(size_t cap)
+        {
+            cap = std::max<size_t>({cap, _writer_idx, 1});
+            if (cap < _buffer.size())
+                _buffer.shrink(cap);
+        };
         // 重置读写位置，初始化缓冲区
         void reset()
         {
@@ -145,7 +295,7 @@ namespace mylog
         }
 
         size_t _MAX_BUFFER_SIZE;
-        std::vector<char> _buffer;
+        BufferStorage _buffer;
         size_t _reader_idx; // 本质是下标
         size_t _writer_idx;
     };
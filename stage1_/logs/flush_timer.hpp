@@ -0,0 +1,119 @@
+/*进程内共享的刷新定时器
+    1.只有一条后台线程，第一次有日志器登记时才启动，服务所有需要定时刷新、自己又没有后台线程的日志器
+     （同步日志器、挂在共享线程池上的异步日志器）
+    2.每个登记项按自己的间隔到期执行一次回调；回调在定时器线程上执行，不持有定时器的锁
+    3.cancel() 返回后回调不会再被调用，也不会正在执行，日志器可以放心析构
+*/
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace mylog
+{
+    class FlushTimer
+    {
+    public:
+        // 故意不析构：进程退出时仍可能有日志器在析构中注销
+        static FlushTimer &getInstance()
+        {
+            static FlushTimer *timer = new FlushTimer();
+            return *timer;
+        }
+
+        // 登记或更新 key（通常是日志器地址）的定时回调，interval 为 0 等同于 cancel()
+        void schedule(const void *key, std::chrono::milliseconds interval, std::function<void()> fn)
+        {
+            if (interval.count() <= 0)
+            {
+                cancel(key);
+                return;
+            }
+            std::unique_lock<std::mutex> lock(_mutex);
+            _idle.wait(lock, [&]
+                       { return _firing != key; });
+            auto it = find(key);
+            if (it == _entries.end())
+                it = _entries.insert(_entries.end(), Entry{key, interval, Clock::time_point(), nullptr});
+            it->interval = interval;
+            it->due = Clock::now() + interval;
+            it->fn = std::move(fn);
+            if (!_thread.joinable())
+                _thread = std::thread(&FlushTimer::threadEntry, this);
+            _cond.notify_one();
+        }
+
+        void cancel(const void *key)
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _idle.wait(lock, [&]
+                       { return _firing != key; });
+            auto it = find(key);
+            if (it != _entries.end())
+                _entries.erase(it);
+        }
+
+    private:
+        using Clock = std::chrono::steady_clock;
+        struct Entry
+        {
+            const void *key;
+            std::chrono::milliseconds interval;
+            Clock::time_point due;
+            std::function<void()> fn;
+        };
+
+        FlushTimer() = default;
+        FlushTimer(const FlushTimer &) = delete;
+        FlushTimer &operator=(const FlushTimer &) = delete;
+
+        std::vector<Entry>::iterator find(const void *key)
+        {
+            return std::find_if(_entries.begin(), _entries.end(), [&](const Entry &e)
+                                { return e.key == key; });
+        }
+
+        void threadEntry()
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            while (1)
+            {
+                if (_entries.empty())
+                {
+                    _cond.wait(lock);
+                    continue;
+                }
+                auto next = std::min_element(_entries.begin(), _entries.end(), [](const Entry &a, const Entry &b)
+                                             { return a.due < b.due; });
+                if (Clock::now() < next->due)
+                {
+                    _cond.wait_until(lock, next->due);
+                    continue; // 期间登记项可能有增删，重新找最早到期的
+                }
+                // 先排好下一次，再放开锁执行回调；执行期间 cancel()/schedule() 会等它结束
+                next->due += next->interval;
+                if (next->due < Clock::now())
+                    next->due = Clock::now() + next->interval; // 回调太慢落后了，不补发
+                std::function<void()> fn = next->fn;
+                _firing = next->key;
+                lock.unlock();
+                fn();
+                lock.lock();
+                _firing = nullptr;
+                _idle.notify_all();
+            }
+        }
+
+        std::mutex _mutex;
+        std::condition_variable _cond; // 唤醒定时器线程
+        std::condition_variable _idle; // 回调执行完毕
+        std::vector<Entry> _entries;
+        const void *_firing = nullptr; // 正在执行回调的登记项
+        std::thread _thread;
+    };
+}
@@ -7,122 +7,140 @@
 #include <cassert>
 #include <vector>
 #include <tuple>
+#include <array>
+#include <utility>
 #include <sstream>
+#include <atomic>
+#include <ctime>
+#include <cstdint>
+#include <cstring>
+#include <thread>
 
 namespace mylog
 {
-    class FormatItem
+    // %d 的时间渲染：除 strftime 的转换符外，额外支持秒以下的小数位：%3N 毫秒、%6N 微秒、%9N / %N 纳秒
+    class TimeRenderer
     {
     public:
-        using ptr = std::shared_ptr<FormatItem>;
-        virtual void format(std::ostream &out, const LogMsg &msg) = 0;
-    };
-
-    // 子项
-    class MsgFormatItem : public FormatItem
-    {
-    public:
-        virtual void format(std::ostream &out, const LogMsg &msg) override
+        explicit TimeRenderer(const std::string &fmt = "%H:%M:%S") : _time_fmt(fmt), _id(nextId())
         {
-            out << msg.getPayload();
+            parse();
         }
-    };
 
-    class LevelFormatItem : public FormatItem
-    {
-    public:
-        virtual void format(std::ostream &out, const LogMsg &msg) override
+        // 每个线程按秒缓存渲染结果：跨秒才调用 localtime_r/strftime，同一秒内只改写小数位
+        const std::string &render(uint64_t ns) const
         {
-            out << mylog::LogLevel::toString(msg.getLevel());
-        }
-    };
-
-    class TimeFormatItem : public FormatItem
-    {
-    public:
-        TimeFormatItem(const std::string &fmt = "%H:%M:%S") : _time_fmt(fmt) {}
-        virtual void format(std::ostream &out, const LogMsg &msg) override
-        {
-            struct tm t;
-            time_t ts = msg.getCtime();
-            localtime_r(&ts, &t);
-            char tmp[64] = {0};
-            strftime(tmp, 31, _time_fmt.c_str(), &t);
-            out << tmp;
+            const time_t sec = static_cast<time_t>(ns / 1000000000ull);
+            static thread_local Cache caches[CACHE_SLOTS];
+            Cache &c = caches[_id % CACHE_SLOTS];
+            if (c.id != _id || c.sec != sec)
+            {
+                rebuild(c, sec);
+            }
+            const uint32_t frac = static_cast<uint32_t>(ns % 1000000000ull);
+            for (auto &slot : c.slots)
+            {
+                uint32_t v = frac;
+                for (int k = 9; k > slot.digits; k--)
+                    v /= 10;
+                char *p = &c.text[slot.pos + slot.digits];
+                for (int k = 0; k < slot.digits; k++)
+                {
+                    *--p = static_cast<char>('0' + v % 10);
+                    v /= 10;
+                }
+            }
+            return c.text;
         }
 
     private:
-        std::string _time_fmt; //%H:%M:%S
-    };
+        static constexpr size_t CACHE_SLOTS = 8;
 
-    class FileFormatItem : public FormatItem
-    {
-    public:
-        virtual void format(std::ostream &out, const LogMsg &msg) override
+        struct Part
         {
-            out << msg.getFile();
-        }
-    };
-
-    class LineFormatItem : public FormatItem
-    {
-    public:
-        virtual void format(std::ostream &out, const LogMsg &msg) override
-        {
-            out << msg.getLine();
-        }
-    };
-
-    class ThreadFormatItem : public FormatItem
-    {
-    public:
-        virtual void format(std::ostream &out, const LogMsg &msg) override
+            std::string strf; // 交给 strftime 的片段
+            int digits;       // >0 表示秒以下小数位
+        };
+        struct Slot
         {
-            out << msg.getTid();
-        }
-    };
-
-    class LoggerFormatItem : public FormatItem
-    {
-    public:
-        virtual void format(std::ostream &out, const LogMsg &msg) override
+            size_t pos;
+            int digits;
+        };
+        struct Cache
         {
-            out << msg.getLogger();
-        }
-    };
+            uint64_t id = 0;
+            time_t sec = -1;
+            std::string text;
+            std::vector<Slot> slots;
+        };
 
-    class NLineFormatItem : public FormatItem
-    {
-    public:
-        virtual void format(std::ostream &out, const LogMsg &msg) override
+        static uint64_t nextId()
         {
-            out << "\r\n";
+            static std::atomic<uint64_t> id{0};
+            return ++id; // 用唯一 id 而不是 this，避免对象复用同一地址时读到旧缓存
         }
-    };
 
-    class OtherFormatItem : public FormatItem
-    {
-    public:
-        OtherFormatItem(const std::string &str) : _str(std::move(str)) {}
-        virtual void format(std::ostream &out, const LogMsg &msg) override
+        // 把格式拆成 strftime 片段与小数位槽位
+        void parse()
         {
-            out << _str;
+            std::string strf;
+            for (size_t i = 0; i < _time_fmt.size(); i++)
+            {
+                char c = _time_fmt[i];
+                if (c != '%' || i + 1 == _time_fmt.size())
+                {
+                    strf.push_back(c);
+                    continue;
+                }
+                char n = _time_fmt[i + 1];
+                int digits = 0;
+                if (n == 'N')
+                    digits = 9;
+                else if ((n == '3' || n == '6' || n == '9') && i + 2 < _time_fmt.size() && _time_fmt[i + 2] == 'N')
+                    digits = n - '0';
+                if (digits == 0)
+                {
+                    // 包括 %%：两个字符一起保留给 strftime
+                    strf.push_back(c);
+                    strf.push_back(n);
+                    i++;
+                    continue;
+                }
+                if (!strf.empty())
+                    _parts.push_back({std::move(strf), 0});
+                strf.clear();
+                _parts.push_back({std::string(), digits});
+                i += (n == 'N') ? 1 : 2;
+            }
+            if (!strf.empty())
+                _parts.push_back({std::move(strf), 0});
         }
 
-    private:
-        std::string _str;
-    };
-
-    class TabFormatItem : public FormatItem
-    {
-    public:
-        virtual void format(std::ostream &out, const LogMsg &msg) override
+        void rebuild(Cache &c, time_t sec) const
         {
-            out << "\t";
+            struct tm t;
+            localtime_r(&sec, &t);
+            c.id = _id;
+            c.sec = sec;
+            c.text.clear();
+            c.slots.clear();
+            for (auto &part : _parts)
+            {
+                if (part.digits > 0)
+                {
+                    c.slots.push_back({c.text.size(), part.digits});
+                    c.text.append(part.digits, '0');
+                    continue;
+                }
+                char tmp[128];
+                size_t n = strftime(tmp, sizeof(tmp), part.strf.c_str(), &t);
+                c.text.append(tmp, n);
+            }
         }
 
-    private:
-        std::string _str;
+        std::string _time_fmt; //%H:%M:%S
+        uint64_t _id;
+        std::vector<Part> _parts;
     };
 
     /*
@@ -137,35 +155,186 @@ namespace mylog
         - `%n` 换行
     */
 
+    // 写入一段定长内存的输出目标：空间不够时只累计长度、不再写入，调用方据此判断是否需要回退
+    struct SpanWriter
+    {
+        char *dst;
+        size_t cap;
+        size_t len = 0;
+        void append(const char *s, size_t n)
+        {
+            if (len + n <= cap)
+                std::memcpy(dst + len, s, n);
+            len += n;
+        }
+    };
+
     class Formatter
     {
     public:
         using ptr = std::shared_ptr<Formatter>;
         Formatter(const std::string &pattern = "[%d{%H:%M:%S}][%t][%c][%f:%l][%p]%T%m%n") : _pattern(pattern)
         {
-            assert(parsePattern());
+            bool ok = parsePattern();
+            assert(ok);
+            (void)ok;
+        };
+        virtual ~Formatter() = default;
+        // 对msg进行格式化：把结果追加到 out 末尾，out 可由调用方反复复用
+        virtual void format(std::string &out, const LogMsg &msg) const
+        {
+            formatOps(out, msg);
+        };
+        // 直接格式化到 [dst, dst+cap)，返回完整结果的长度；返回值大于 cap 时内容不完整，调用方应回退到 format()
+        // 重写了 format(std::string&) 的子类需要同时重写它
+        virtual size_t formatTo(char *dst, size_t cap, const LogMsg &msg) const
+        {
+            SpanWriter w{dst, cap};
+            formatOps(w, msg);
+            return w.len;
+        }
+        // 粗略估计格式化结果的长度（偏大），用于就地格式化前预留空间
+        size_t estimateSize(const LogMsg &msg) const
+        {
+            return _literals.size() + msg.getPayload().size() + msg.getFile().size() + msg.getLogger().size() +
+                   32 * _ops.size();
+        }
+        void format(std::ostream &out, const LogMsg &msg) const
+        {
+            std::string &buf = threadBuffer();
+            buf.clear();
+            format(buf, msg);
+            out.write(buf.data(), buf.size());
+        };
+        std::string format(const LogMsg &msg) const
+        {
+            std::string out;
+            format(out, msg);
+            return out;
         };
-        // 对msg进行格式化
 
-        void format(std::ostream &out, LogMsg &msg)
+    private:
+        // 编译后的指令：LITERAL 指向 _literals 中的一段，TIME 指向 _times 中的下标
+        enum class OpCode : uint8_t
         {
-            for (auto &item : _items)
-            {
-                item->format(out, msg);
-            }
+            LITERAL,
+            TIME,
+            THREAD,
+            LOGGER,
+            FILE,
+            LINE,
+            LEVEL,
+            MSG
         };
-        std::string format(LogMsg &msg)
+        struct Op
         {
-            std::stringstream ss;
-            format(ss, msg);
-            return ss.str();
+            OpCode code;
+            uint32_t arg;
+            uint32_t len;
         };
 
+    protected:
+        // 解释执行指令序列，Out 为 std::string 或 SpanWriter
+        template <typename Out>
+        void formatOps(Out &out, const LogMsg &msg) const
+        {
+            for (const Op &op : _ops)
+            {
+                switch (op.code)
+                {
+                case OpCode::LITERAL:
+                    out.append(_literals.data() + op.arg, op.len);
+                    break;
+                case OpCode::TIME:
+                    appendStr(out, _times[op.arg].render(msg.getCtimeNs()));
+                    break;
+                case OpCode::THREAD:
+                    appendTid(out, msg.getTid());
+                    break;
+                case OpCode::LOGGER:
+                    out.append(msg.getLogger().data(), msg.getLogger().size());
+                    break;
+                case OpCode::FILE:
+                    out.append(msg.getFile().data(), msg.getFile().size());
+                    break;
+                case OpCode::LINE:
+                    appendUint(out, msg.getLine());
+                    break;
+                case OpCode::LEVEL:
+                    appendCStr(out, LogLevel::toString(msg.getLevel()));
+                    break;
+                case OpCode::MSG:
+                    appendStr(out, msg.getPayload());
+                    break;
+                }
+            }
+        }
+
+        template <typename Out>
+        static void appendStr(Out &out, const std::string &s) { out.append(s.data(), s.size()); }
+        template <typename Out>
+        static void appendCStr(Out &out, const char *s) { out.append(s, std::strlen(s)); }
+
+        static std::string &threadBuffer()
+        {
+            static thread_local std::string buf;
+            return buf;
+        }
+
+        template <typename Out>
+        static void appendUint(Out &out, size_t v)
+        {
+            char tmp[24];
+            char *p = tmp + sizeof(tmp);
+            do
+            {
+                *--p = static_cast<char>('0' + v % 10);
+                v /= 10;
+            } while (v);
+            out.append(p, tmp + sizeof(tmp) - p);
+        }
+
+        // 线程 id 的文本形式按线程缓存，只在 id 变化时才走一次 ostream
+        template <typename Out>
+        static void appendTid(Out &out, std::thread::id tid)
+        {
+            struct Cache
+            {
+                std::thread::id id;
+                std::string text;
+                bool valid = false;
+            };
+            static thread_local Cache c;
+            if (!c.valid || c.id != tid)
+            {
+                std::ostringstream ss;
+                ss << tid;
+                c.id = tid;
+                c.text = ss.str();
+                c.valid = true;
+            }
+            appendStr(out, c.text);
+        }
+
     private:
+        void addLiteral(const std::string &str)
+        {
+            if (str.empty())
+                return;
+            // 相邻的字面量合并成一段
+            if (!_ops.empty() && _ops.back().code == OpCode::LITERAL && _ops.back().arg + _ops.back().len == _literals.size())
+                _ops.back().len += static_cast<uint32_t>(str.size());
+            else
+                _ops.push_back({OpCode::LITERAL, static_cast<uint32_t>(_literals.size()), static_cast<uint32_t>(str.size())});
+            _literals += str;
+        }
+
         // 对格式化规则字符串进行解析
         bool parsePattern()
         {
-            _items.clear();
+            _ops.clear();
+            _literals.clear();
+            _times.clear();
             // 1.对格式化规则字符串进行解析
             // asda%%[%d{%H:%M:%S}][%p]%T%m%n
             std::vector<std::pair<std::string, std::string>> fmt_ord;
@@ -230,44 +399,225 @@ namespace mylog
                 pos++;
             }
             flush_literal();
-            // 2.添加到_items中
+            // 2.编译成指令序列
             for (auto &kv : fmt_ord)
             {
-                auto item = createItem(kv.first, kv.second);
-                if (!item)
-                    return false; // 未知键等错误
-                _items.push_back(std::move(item));
+                if (!compileItem(kv.first, kv.second))
+                    return false;
             }
             return true;
         };
 
     private:
-        // 根据不同的格式化字符创建不同的格式化子项对象
-        FormatItem::ptr createItem(const std::string &key, const std::string &val)
+        // 根据不同的格式化字符生成对应指令
+        bool compileItem(const std::string &key, const std::string &val)
         {
             if (key == "d")
-                return std::make_shared<TimeFormatItem>(val);
+            {
+                _ops.push_back({OpCode::TIME, static_cast<uint32_t>(_times.size()), 0});
+                _times.emplace_back(val.empty() ? DEFAULT_TIME_FMT : val);
+            }
             else if (key == "t")
-                return std::make_shared<ThreadFormatItem>();
+                _ops.push_back({OpCode::THREAD, 0, 0});
             else if (key == "c")
-                return std::make_shared<LoggerFormatItem>();
+                _ops.push_back({OpCode::LOGGER, 0, 0});
             else if (key == "f")
-                return std::make_shared<FileFormatItem>();
+                _ops.push_back({OpCode::FILE, 0, 0});
             else if (key == "l")
-                return std::make_shared<LineFormatItem>();
+                _ops.push_back({OpCode::LINE, 0, 0});
             else if (key == "p")
-                return std::make_shared<LevelFormatItem>();
+                _ops.push_back({OpCode::LEVEL, 0, 0});
             else if (key == "T")
-                return std::make_shared<TabFormatItem>();
+                addLiteral("\t");
             else if (key == "m")
-                return std::make_shared<MsgFormatItem>();
+                _ops.push_back({OpCode::MSG, 0, 0});
             else if (key == "n")
-                return std::make_shared<NLineFormatItem>();
-            return std::make_shared<OtherFormatItem>(val);
+                addLiteral("\r\n");
+            else
+                addLiteral(val); // 未知键与字面量一样原样输出
+            return true;
         };
 
+    private:
+    protected:
+        static constexpr const char *DEFAULT_TIME_FMT = "%H:%M:%S"; // 不带 {} 的 %d
+
     private:
         std::string _pattern;
-        std::vector<FormatItem::ptr> _items;
+        std::vector<Op> _ops;
+        std::string _literals;
+        std::vector<TimeRenderer> _times;
+    };
+
+    namespace details
+    {
+        // 编译期解析出的模式串片段：key 为 0 表示字面量 [begin, end)，否则为占位符，[begin, end) 是 {} 内的子串
+        struct PatternToken
+        {
+            char key;
+            size_t begin;
+            size_t end;
+        };
+
+        constexpr bool isPatternKey(char c)
+        {
+            return c == 'd' || c == 't' || c == 'c' || c == 'f' || c == 'l' ||
+                   c == 'p' || c == 'T' || c == 'm' || c == 'n';
+        }
+
+        // 与 Formatter::parsePattern 的规则一致；out 为空时只计数。遇到未知键、孤立的 % 或缺少 } 时返回 false
+        constexpr bool scanPattern(const char *p, PatternToken *out, size_t &count)
+        {
+            count = 0;
+            auto emit = [&](char key, size_t b, size_t e)
+            {
+                if (out)
+                    out[count] = PatternToken{key, b, e};
+                count++;
+            };
+            size_t i = 0, lit = 0;
+            while (p[i])
+            {
+                if (p[i] != '%')
+                {
+                    i++;
+                    continue;
+                }
+                if (lit < i)
+                    emit(0, lit, i);
+                i++;
+                if (!p[i])
+                    return false;
+                if (p[i] == '%')
+                {
+                    emit(0, i, i + 1);
+                    lit = ++i;
+                    continue;
+                }
+                char key = p[i];
+                if (!isPatternKey(key))
+                    return false;
+                if (p[i + 1] == '{')
+                {
+                    size_t close = i + 2;
+                    while (p[close] && p[close] != '}')
+                        close++;
+                    if (!p[close])
+                        return false;
+                    emit(key, i + 2, close);
+                    i = close + 1;
+                }
+                else
+                {
+                    emit(key, 0, 0);
+                    i++;
+                }
+                lit = i;
+            }
+            if (lit < i)
+                emit(0, lit, i);
+            return true;
+        }
+    }
+
+    /*编译期模式串：Pattern 必须是静态存储期的字符数组，例如
+        static constexpr char kPattern[] = "[%d][%p]%m%n";
+        builder->buildLoggerFormatter<kPattern>();
+      解析在编译期完成，格式化展开成一串直接的追加调用；未知的 % 键会编译失败
+    */
+    template <const char *Pattern>
+    class StaticFormatter : public Formatter
+    {
+        static constexpr size_t tokenCount()
+        {
+            size_t n = 0;
+            details::scanPattern(Pattern, nullptr, n);
+            return n;
+        }
+        static constexpr bool valid()
+        {
+            size_t n = 0;
+            return details::scanPattern(Pattern, nullptr, n);
+        }
+        static_assert(valid(), "日志模式串非法：未知的 % 键、孤立的 % 或缺少 }");
+
+        static constexpr size_t N = tokenCount();
+        static constexpr std::array<details::PatternToken, N> tokens()
+        {
+            std::array<details::PatternToken, N> a{};
+            size_t n = 0;
+            details::scanPattern(Pattern, a.data(), n);
+            return a;
+        }
+        static constexpr std::array<details::PatternToken, N> TOKENS = tokens();
+
+        // 第 I 个片段之前有几个 %d，即它在 _static_times 中的下标
+        template <size_t I>
+        static constexpr size_t timeIndex()
+        {
+            size_t n = 0;
+            for (size_t k = 0; k < I; k++)
+                n += TOKENS[k].key == 'd';
+            return n;
+        }
+
+    public:
+        StaticFormatter() : Formatter(Pattern)
+        {
+            for (auto &t : TOKENS)
+            {
+                if (t.key == 'd')
+                    _static_times.emplace_back(t.begin == t.end ? std::string(DEFAULT_TIME_FMT)
+                                                                : std::string(Pattern + t.begin, t.end - t.begin));
+            }
+        }
+        using Formatter::format;
+        virtual void format(std::string &out, const LogMsg &msg) const override
+        {
+            formatAll(out, msg, std::make_index_sequence<N>());
+        }
+        virtual size_t formatTo(char *dst, size_t cap, const LogMsg &msg) const override
+        {
+            SpanWriter w{dst, cap};
+            formatAll(w, msg, std::make_index_sequence<N>());
+            return w.len;
+        }
+
+    private:
+        template <typename Out, size_t... I>
+        void formatAll(Out &out, const LogMsg &msg, std::index_sequence<I...>) const
+        {
+            (void)out;
+            (void)msg;
+            (emit<I>(out, msg), ...);
+        }
+
+        template <size_t I, typename Out>
+        void emit(Out &out, const LogMsg &msg) const
+        {
+            constexpr details::PatternToken t = TOKENS[I];
+            if constexpr (t.key == 0)
+                out.append(Pattern + t.begin, t.end - t.begin);
+            else if constexpr (t.key == 'd')
+                appendStr(out, _static_times[timeIndex<I>()].render(msg.getCtimeNs()));
+            else if constexpr (t.key == 't')
+                appendTid(out, msg.getTid());
+            else if constexpr (t.key == 'c')
+                out.append(msg.getLogger().data(), msg.getLogger().size());
+            else if constexpr (t.key == 'f')
+                out.append(msg.getFile().data(), msg.getFile().size());
+            else if constexpr (t.key == 'l')
+                appendUint(out, msg.getLine());
+            else if constexpr (t.key == 'p')
+                appendCStr(out, LogLevel::toString(msg.getLevel()));
+            else if constexpr (t.key == 'T')
+                out.append("\t", 1);
+            else if constexpr (t.key == 'm')
+                appendStr(out, msg.getPayload());
+            else if constexpr (t.key == 'n')
+                out.append("\r\n", 2);
+        }
+
+        std::vector<TimeRenderer> _static_times;
     };
 }
@@ -10,10 +10,16 @@
 #include "format.hpp"
 #include "sink.hpp"
 #include "looper.hpp"
+#include "ring_looper.hpp"
+#include "thread_looper.hpp"
+#include "pool_looper.hpp"
+#include "flush_timer.hpp"
 #include "buffer.hpp"
+#include "record.hpp"
 
 #include <atomic>
 #include <mutex>
+#include <condition_variable>
 #include <sstream>
 #include <cstdarg> // va_list, va_start, va_end
 #include <cstdio>  // vasprintf（GNU 扩展，建议也包含）
@@ -40,12 +46,22 @@ namespace mylog
             : _logger_name(std::move(name)),
               _limit_level(level),
               _formatter(std::move(formatter)),
-              _sinks(std::move(sinks))
+              _sinks(std::move(sinks)),
+              _logger_id(nextId())
         {
         } // 成员里统一 move
 
         virtual ~Logger() = default;
 
+        // 进程内唯一的日志器 id，写在异步记录头里，落地可据此区分来源
+        uint32_t id() const { return _logger_id; }
+
+        // 宏在求值参数前先调用它，被过滤的日志不做任何格式化
+        bool shouldLog(LogLevel::value level) const noexcept
+        {
+            return level >= _limit_level.load(std::memory_order_relaxed);
+        }
+
         /*
         构造日志消息对象过程并进行格式化，得到格式化后的日志消息字符串--等待进行落地输出
         通过传入的参数构造出一个日志消息对象，进行日志的格式化，最后落地
@@ -56,6 +72,63 @@ namespace mylog
             5.进行日志落地
         */
 
+        // 宏入口：每个调用点一个静态 LogSite（file/line/level/fmt），每条日志只传它的引用
+        template <typename... Args>
+        void debug(const LogSite &site, const Args &...args) { common_level(site, args...); }
+        template <typename... Args>
+        void info(const LogSite &site, const Args &...args) { common_level(site, args...); }
+        template <typename... Args>
+        void warn(const LogSite &site, const Args &...args) { common_level(site, args...); }
+        template <typename... Args>
+        void error(const LogSite &site, const Args &...args) { common_level(site, args...); }
+        template <typename... Args>
+        void fatal(const LogSite &site, const Args &...args) { common_level(site, args...); }
+
+        // 宏入口（格式串不是字面量）：格式串只在本次调用内有效，立即格式化
+        template <typename... Args>
+        void debug(const RuntimeSite &rs, const Args &...args) { common_level_now(rs.site, args...); }
+        template <typename... Args>
+        void info(const RuntimeSite &rs, const Args &...args) { common_level_now(rs.site, args...); }
+        template <typename... Args>
+        void warn(const RuntimeSite &rs, const Args &...args) { common_level_now(rs.site, args...); }
+        template <typename... Args>
+        void error(const RuntimeSite &rs, const Args &...args) { common_level_now(rs.site, args...); }
+        template <typename... Args>
+        void fatal(const RuntimeSite &rs, const Args &...args) { common_level_now(rs.site, args...); }
+
+        // 模板前端：参数类型编译期检查，直接格式化进线程内复用的缓冲区（不再 vasprintf/free）
+        // file/fmt 由调用者持有、不保证静态存储期，开启延迟格式化时也在调用线程立即格式化
+        template <typename... Args>
+        void debug(const char *file, size_t line, const char *fmt, const Args &...args)
+        {
+            common_level_now(LogSite(file, line, LogLevel::value::DEBUG, fmt), args...);
+        }
+
+        template <typename... Args>
+        void info(const char *file, size_t line, const char *fmt, const Args &...args)
+        {
+            common_level_now(LogSite(file, line, LogLevel::value::INFO, fmt), args...);
+        }
+
+        template <typename... Args>
+        void warn(const char *file, size_t line, const char *fmt, const Args &...args)
+        {
+            common_level_now(LogSite(file, line, LogLevel::value::WARN, fmt), args...);
+        }
+
+        template <typename... Args>
+        void error(const char *file, size_t line, const char *fmt, const Args &...args)
+        {
+            common_level_now(LogSite(file, line, LogLevel::value::ERROR, fmt), args...);
+        }
+
+        template <typename... Args>
+        void fatal(const char *file, size_t line, const char *fmt, const Args &...args)
+        {
+            common_level_now(LogSite(file, line, LogLevel::value::FATAL, fmt), args...);
+        }
+
+        // printf 风格（va_list）接口，保留兼容：file/fmt 为 std::string 时走这里
         void debug(const std::string &file, size_t line,
                    const std::string fmt, ...)
         {
@@ -104,37 +177,239 @@ namespace mylog
 
         virtual void setMaxBufferSize(size_t max_size) {}
 
+        // 阻塞到调用之前写入的日志都已交给各落地方向、且各落地方向都已刷新
+        virtual void flush() {}
+        // 等级不低于 level 的日志写出后随即刷新各落地方向（默认 OFF：从不）；
+        // 异步日志器由后台线程在这一批写完后刷新，生产者不会因此阻塞
+        void flushOn(LogLevel::value level)
+        {
+            _flush_level.store(level, std::memory_order_relaxed);
+        }
+        // 有数据写出后最多约 interval 就刷新一次落地，限定数据停留在用户态缓冲里的时间（0 关闭）
+        virtual void flushEvery(std::chrono::milliseconds interval) { (void)interval; }
+
     private: //(protected)
+        template <typename... Args>
+        void common_level(const LogSite &site, const Args &...args)
+        {
+            if (!shouldLog(site.level))
+            {
+                return;
+            }
+            if (_deferred)
+            {
+                logDeferred(site, args...);
+                return;
+            }
+            ScratchLease s;
+            LogMsg &msg = fillMsg(s->msg, site);
+            util::Printf::format(msg.payloadBuffer(), site.fmt, args...);
+            formatAndLog(*s);
+        }
+
+        // 不论是否开启延迟格式化都在调用线程格式化（site.fmt 不保证静态存储期）
+        template <typename... Args>
+        void common_level_now(const LogSite &site, const Args &...args)
+        {
+            if (!shouldLog(site.level))
+            {
+                return;
+            }
+            ScratchLease s;
+            LogMsg &msg = fillMsg(s->msg, site);
+            util::Printf::format(msg.payloadBuffer(), site.fmt, args...);
+            formatAndLog(*s);
+        }
+
         void common_level(const LogLevel::value level,
                           const std::string &file,
                           const size_t line,
                           va_list ap,
                           const std::string fmt)
         {
-            // std::atomic<T> 没有隐式转换，依赖实现可能不编；规范写法要 load()。
-            if (level < _limit_level.load(std::memory_order_relaxed))
+            if (!shouldLog(level))
             {
                 return;
             }
 
-            char *res;
-            int ret = vasprintf(&res, fmt.c_str(), ap);
-            assert(ret != -1);
-            LogMsg msg(_logger_name, file, line, res, level);
-            free(res);
-            std::stringstream ss;
-            _formatter->format(ss, msg);
-            std::string str = ss.str();
-            log(str.c_str(), str.size());
+            ScratchLease s;
+            LogMsg &msg = fillMsg(s->msg, LogSite(file.c_str(), line, level, fmt.c_str()));
+            util::Printf::vformat(msg.payloadBuffer(), fmt.c_str(), ap);
+            formatAndLog(*s);
+        }
+
+        // 每个线程复用一份暂存：LogMsg 的 file/logger 只是视图，payload 和两个缓冲的容量只增不减，稳态下不再分配
+        struct Scratch
+        {
+            LogMsg msg;
+            std::string rec;  // 异步：整条记录
+            std::string text; // 同步：格式化结果
+        };
+        // 借用本线程的暂存；落地或格式化过程中又写日志（重入，可能是另一个日志器）时，
+        // 线程暂存仍被外层占用，内层改用一份局部暂存，不覆盖外层的消息和正在落地的文本
+        class ScratchLease
+        {
+        public:
+            ScratchLease()
+            {
+                if (busy())
+                {
+                    _local.reset(new Scratch());
+                    _s = _local.get();
+                }
+                else
+                {
+                    busy() = true;
+                    _s = &shared();
+                }
+            }
+            ~ScratchLease()
+            {
+                if (!_local)
+                    busy() = false;
+            }
+            ScratchLease(const ScratchLease &) = delete;
+            ScratchLease &operator=(const ScratchLease &) = delete;
+
+            Scratch &operator*() const { return *_s; }
+            Scratch *operator->() const { return _s; }
+
+        private:
+            static Scratch &shared()
+            {
+                static thread_local Scratch s;
+                return s;
+            }
+            static bool &busy()
+            {
+                static thread_local bool b = false;
+                return b;
+            }
+            Scratch *_s;
+            std::unique_ptr<Scratch> _local;
+        };
+
+        LogMsg &fillMsg(LogMsg &msg, const LogSite &site)
+        {
+            msg.setCtimeNs(stamp())
+                .setSite(site)
+                .setTidToCurrent()
+                .setLogger(_logger_name);
+            return msg;
+        }
+
+        // 延迟格式化：只记录调用点、时间戳和原始参数字节，由后台线程按 ArgCodec 还原后再格式化
+        template <typename... Args>
+        void logDeferred(const LogSite &site, const Args &...args)
+        {
+            using Codec = ArgCodec<Args...>;
+            const size_t body = sizeof(DeferredHead) + Codec::encodedSize(args...);
+            ScratchLease s;
+            std::string &rec = s->rec;
+            rec.resize(Record::frameSize(body));
+            RecordHeader h{static_cast<uint32_t>(rec.size()), static_cast<uint32_t>(body),
+                           RecordKind::DEFERRED, static_cast<uint16_t>(site.level), _logger_id};
+            DeferredHead d{stamp(), std::this_thread::get_id(), site, &Codec::render};
+            std::memcpy(&rec[0], &h, sizeof(h));
+            std::memcpy(&rec[sizeof(h)], &d, sizeof(d));
+            Codec::encode(&rec[sizeof(h) + sizeof(d)], args...);
+            logRecord(rec.data(), rec.size(), site.level);
+        }
+
+        void formatAndLog(Scratch &s)
+        {
+            const LogMsg &msg = s.msg;
+            if (_framed)
+            {
+                // 异步：优先在异步缓冲里预留空间，持锁直接格式化进去（省掉一次拷贝）
+                InPlaceText ctx{_formatter.get(), &msg, _logger_id};
+                if (logInPlace(Record::frameSize(_formatter->estimateSize(msg)), msg.getLevel(), &writeInPlace, &ctx))
+                    return;
+                // 回退：工作器不支持、空间不足或估计偏小，先格式化到线程内缓冲再整条写入
+                std::string &rec = s.rec;
+                rec.clear();
+                size_t off = Record::beginText(rec);
+                _formatter->format(rec, msg);
+                Record::finishText(rec, off, msg.getLevel(), _logger_id);
+                logRecord(rec.data(), rec.size(), msg.getLevel());
+                return;
+            }
+            std::string &str = s.text;
+            str.clear();
+            _formatter->format(str, msg);
+            log(str.c_str(), str.size(), msg.getLevel());
+        }
+        struct InPlaceText
+        {
+            const Formatter *formatter;
+            const LogMsg *msg;
+            uint32_t logger;
+        };
+        // 在异步缓冲预留的 cap 字节里写一条 TEXT 记录；放不下时返回所需长度，由工作器放弃本次写入
+        static size_t writeInPlace(char *dst, size_t cap, void *ctx)
+        {
+            const InPlaceText &t = *static_cast<const InPlaceText *>(ctx);
+            if (cap < sizeof(RecordHeader))
+                return Record::frameSize(0);
+            size_t len = t.formatter->formatTo(dst + sizeof(RecordHeader), cap - sizeof(RecordHeader), *t.msg);
+            size_t frame = Record::frameSize(len);
+            if (frame > cap)
+                return frame;
+            Record::finishText(dst, len, t.msg->getLevel(), t.logger);
+            return frame;
+        }
+
+        virtual void log(const char *data, size_t len, LogLevel::value level)
+        {
+            (void)data;
+            (void)len;
+            (void)level;
+        }
+        virtual void logRecord(const char *data, size_t len, LogLevel::value level)
+        {
+            (void)data;
+            (void)len;
+            (void)level;
+        }
+        // 本条日志的时间戳；异步日志器交给工作器去取（见 Looper::stamp）
+        virtual uint64_t stamp() { return util::Date::nowNs(); }
+        virtual bool logInPlace(size_t reserve, LogLevel::value level, InPlaceWriter writer, void *ctx)
+        {
+            (void)reserve;
+            (void)level;
+            (void)writer;
+            (void)ctx;
+            return false;
         }
-        virtual void log(const char *data, size_t len) {}
 
     protected:
+        bool shouldFlush(LogLevel::value level) const
+        {
+            LogLevel::value f = _flush_level.load(std::memory_order_relaxed);
+            return f != LogLevel::value::OFF && level >= f;
+        }
+        void flushSinks()
+        {
+            for (auto &sink : _sinks)
+                sink->flush();
+        }
+
         std::mutex _mutex;
         std::string _logger_name;
         std::atomic<LogLevel::value> _limit_level; // 原子化元素，避免高频访问带来的性能降低
+        std::atomic<LogLevel::value> _flush_level{LogLevel::value::OFF}; // flushOn() 设置的刷新等级
         Formatter::ptr _formatter;
         std::vector<LogSink::ptr> _sinks;
+        bool _framed = false;   // 异步日志器：写入缓冲的是带记录头的二进制记录（见 record.hpp）
+        bool _deferred = false; // 仅异步日志器可开启：生产者写二进制记录，后台线程格式化
+
+    private:
+        static uint32_t nextId()
+        {
+            static std::atomic<uint32_t> next{1};
+            return next.fetch_add(1, std::memory_order_relaxed);
+        }
+        const uint32_t _logger_id;
     };
 
     class SyncLogger : public Logger
@@ -146,9 +421,34 @@ namespace mylog
                    std::vector<LogSink::ptr> sinks)
             : Logger(name, level, formatter, sinks) {};
 
+        ~SyncLogger()
+        {
+            if (_timed)
+                FlushTimer::getInstance().cancel(this);
+        }
+
+        virtual void flush() override
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            flushSinks();
+            _dirty = false;
+        }
+
+        // 同步日志器没有后台线程，交给进程共享的定时器；到期时有新写入才刷新
+        virtual void flushEvery(std::chrono::milliseconds interval) override
+        {
+            _timed = _timed || interval.count() > 0;
+            FlushTimer::getInstance().schedule(this, interval, [this]
+                                               {
+                std::unique_lock<std::mutex> lock(_mutex);
+                if (_dirty)
+                    flushSinks();
+                _dirty = false; });
+        }
+
     private:
         // 同步日志器，将日志直接通过落地模块进行日志落地
-        virtual void log(const char *data, size_t len) override
+        virtual void log(const char *data, size_t len, LogLevel::value level) override
         {
             std::unique_lock<std::mutex> lock(_mutex);
             if (_sinks.empty())
@@ -159,7 +459,27 @@ namespace mylog
             {
                 sink->log(data, len);
             }
+            _dirty = !shouldFlush(level);
+            if (!_dirty)
+                flushSinks();
         }
+
+        bool _dirty = false; // 上次刷新之后有过写入，受 _mutex 保护
+        bool _timed = false; // 登记过共享定时器
+    };
+
+    // 异步日志器的可选项，由建造者统一收集
+    struct AsyncOptions
+    {
+        bool deferred = false;                        // 延迟格式化
+        LooperType looper = LooperType::LOOPER_MUTEX; // 异步工作器实现
+        size_t ring_size = 0;                         // 环/每线程队列大小，0 取各实现的默认值
+        OverflowConfig overflow;                      // 缓冲区写满时的处理方式
+        WakeupConfig wakeup;                          // 消费者批量唤醒（仅 LOOPER_MUTEX）
+        size_t pool_threads = 0;                      // 共享线程池的最少线程数（仅 LOOPER_SHARED_POOL），0 取默认值
+        StorageConfig storage;                        // 缓冲区存储：大页/预先缺页（LOOPER_MUTEX、LOOPER_SHARED_POOL）
+        ShrinkConfig shrink;                          // 缓冲区初始容量与弹性收缩（仅 LOOPER_MUTEX）
+        BufferPoolConfig pool;                        // 多缓冲池（仅 LOOPER_MUTEX）
     };
 
     class AsyncLogger : public Logger
@@ -168,51 +488,227 @@ namespace mylog
         AsyncLogger(std::string name,         // 按值
                     LogLevel::value level,    // 按值
                     Formatter::ptr formatter, // 按值（shared_ptr 拷一次或移动）
-                    std::vector<LogSink::ptr> sinks)
-            : Logger(name, level, formatter, sinks),
-              _looper(std::make_shared<AsyncLooper>(std::bind(&AsyncLogger::realLog, this, std::placeholders::_1))) {};
+                    std::vector<LogSink::ptr> sinks,
+                    const AsyncOptions &opts = AsyncOptions())
+            : Logger(name, level, formatter, sinks)
+        {
+            _framed = true;
+            _deferred = opts.deferred;
+            Functor cb = std::bind(&AsyncLogger::realLog, this, std::placeholders::_1);
+            if (opts.looper == LooperType::LOOPER_RING)
+                _looper = std::make_shared<RingLooper>(cb, opts.ring_size, opts.overflow);
+            else if (opts.looper == LooperType::LOOPER_PER_THREAD)
+                _looper = std::make_shared<ThreadQueueLooper>(cb, opts.ring_size, opts.overflow);
+            else if (opts.looper == LooperType::LOOPER_SHARED_POOL)
+                _looper = std::make_shared<PooledLooper>(cb, opts.pool_threads, opts.overflow, opts.storage);
+            else
+                _looper = std::make_shared<AsyncLooper>(cb, opts.overflow, opts.wakeup, opts.storage, opts.shrink, opts.pool);
+        };
 
-        virtual void log(const char *data, size_t len) override
+        ~AsyncLogger()
         {
-            _looper->push(data, len);
+            if (_timed)
+                FlushTimer::getInstance().cancel(this);
+        }
+
+        virtual void log(const char *data, size_t len, LogLevel::value level) override
+        {
+            _looper->push(data, len, level);
         };
-        void realLog(Buffer &buf)
+        virtual void logRecord(const char *data, size_t len, LogLevel::value level) override
         {
-            if (_sinks.empty())
+            _looper->push(data, len, level);
+        };
+        virtual bool logInPlace(size_t reserve, LogLevel::value level, InPlaceWriter writer, void *ctx) override
+        {
+            return _looper->pushInPlace(reserve, level, writer, ctx);
+        }
+        virtual uint64_t stamp() override
+        {
+            return _looper->stamp();
+        }
+        // 因溢出策略被丢弃的累计条数/字节数
+        size_t droppedMessages() const { return _looper->droppedMessages(); }
+        size_t droppedBytes() const { return _looper->droppedBytes(); }
+        // 主动唤醒后台线程的次数
+        size_t wakeups() const { return _looper->wakeups(); }
+
+        // 在缓冲区里放一条 FLUSH 标记，等后台线程处理到它：此前写入的记录都已落地并刷新。
+        // 标记不会被溢出策略拒绝，但 DROP_OLDEST 可能连同旧记录一起把它丢掉，
+        // 所以等待超时且期间有丢弃时重发一次（序号不变，处理到任意一条即可）
+        virtual void flush() override
+        {
+            uint64_t seq = nextFlushSeq();
+            size_t drops = _looper->droppedMessages();
+            pushFlushMarker(seq);
+            std::unique_lock<std::mutex> lock(_flush_mutex);
+            while (!_flush_cond.wait_for(lock, FLUSH_RETRY, [&]
+                                         { return _flush_done >= seq; }))
             {
-                return;
+                size_t now = _looper->droppedMessages();
+                if (now == drops)
+                    continue;
+                drops = now;
+                lock.unlock();
+                pushFlushMarker(seq);
+                lock.lock();
             }
+        }
 
-            const char *p = buf.readPtr();
-            const char *end = p + buf.readableSize();
-            const char *line = p;
+        // 后台线程忙时每批检查一次是否到了刷新时间，空闲时由工作器的空闲定时（空 Buffer 回调）兜底；
+        // 共享线程池上的日志器没有自己的后台线程，改由共享定时器到期时放一条 FLUSH 标记（不等待）
+        virtual void flushEvery(std::chrono::milliseconds interval) override
+        {
+            _flush_interval_ms.store(interval.count(), std::memory_order_relaxed);
+            if (_looper->setTickInterval(interval))
+                return;
+            _timed = _timed || interval.count() > 0;
+            FlushTimer::getInstance().schedule(this, interval, [this]
+                                               {
+                if (_dirty.load(std::memory_order_relaxed))
+                    pushFlushMarker(nextFlushSeq()); });
+        }
+
+        // 没有落地方向时也要走一遍记录，否则 FLUSH 标记得不到处理，flush() 会一直等下去
+        // 空 Buffer 是工作器的空闲定时回调：有未刷新的数据就刷新
+        void realLog(Buffer &buf)
+        {
+            bool urgent = renderRecords(buf);
+            reportDrops();
+            if (urgent || (_dirty.load(std::memory_order_relaxed) && (buf.empty() || flushDue())))
+                syncSinks();
+        };
 
-            while (line < end)
+        virtual void setMaxBufferSize(size_t max_size) override
+        {
+            if (_looper)
             {
-                // 找下一条换行（Windows 下行尾是 "\r\n"，找 '\n' 也没问题）
-                const char *nl = static_cast<const char *>(
-                    ::memchr(line, '\n', static_cast<size_t>(end - line)));
+                _looper->setMaxBufferSize(max_size);
+            }
+        }
 
-                size_t len = nl ? static_cast<size_t>(nl - line + 1)
-                                : static_cast<size_t>(end - line); // 最后一条可能没 '\n'
+    private:
+        // 后台线程：追上进度后，把这段时间内被丢弃的条数作为一行摘要写入各落地方向
+        void reportDrops()
+        {
+            size_t msgs = _looper->droppedMessages();
+            if (msgs == _reported_msgs)
+                return;
+            size_t bytes = _looper->droppedBytes();
+            char line[256];
+            int n = snprintf(line, sizeof(line), "[%s] %zu messages dropped (%zu bytes)\n",
+                             _logger_name.c_str(), msgs - _reported_msgs, bytes - _reported_bytes);
+            _reported_msgs = msgs;
+            _reported_bytes = bytes;
+            if (n <= 0)
+                return;
+            size_t len = std::min(static_cast<size_t>(n), sizeof(line) - 1);
+            _dirty.store(true, std::memory_order_relaxed);
+            for (auto &sink : _sinks)
+                sink->log(line, len);
+        }
 
-                for (auto &sink : _sinks)
-                    sink->log(line, len);
+        uint64_t nextFlushSeq()
+        {
+            std::lock_guard<std::mutex> lk(_flush_mutex);
+            return ++_flush_requested;
+        }
 
-                if (!nl)
+        void pushFlushMarker(uint64_t seq)
+        {
+            char rec[Record::frameSize(sizeof(seq))] = {};
+            RecordHeader h{static_cast<uint32_t>(sizeof(rec)), static_cast<uint32_t>(sizeof(seq)),
+                           RecordKind::FLUSH, static_cast<uint16_t>(LogLevel::value::OFF), id()};
+            std::memcpy(rec, &h, sizeof(h));
+            std::memcpy(rec + sizeof(h), &seq, sizeof(seq));
+            _looper->push(rec, sizeof(rec), LogLevel::value::OFF);
+        }
+
+        // 后台线程：处理到 FLUSH 标记时，先把它之前的记录交出去并刷新落地，再通知 flush() 的调用者
+        void completeFlush(const char *body)
+        {
+            uint64_t seq;
+            std::memcpy(&seq, body, sizeof(seq));
+            flushBatch();
+            reportDrops();
+            syncSinks();
+            std::lock_guard<std::mutex> lk(_flush_mutex);
+            _flush_done = std::max(_flush_done, seq);
+            _flush_cond.notify_all();
+        }
+
+        // 后台线程：按记录头逐条跳转（不扫描文本），DEFERRED 在这里才真正格式化；
+        // 整批文本拼接后连同每条记录的长度/等级/日志器 id 一次交给各落地方向
+        // 返回本批中是否有达到 flushOn() 等级的记录（FLUSH 标记之后的）
+        bool renderRecords(Buffer &buf)
+        {
+            const char *p = buf.readPtr();
+            size_t avail = buf.readableSize();
+            bool urgent = false;
+            RecordHeader h;
+            while (Record::peek(p, avail, h))
+            {
+                const char *body = Record::body(p);
+                size_t before = _backend_text.size();
+                if (h.kind == RecordKind::FLUSH)
+                {
+                    completeFlush(body);
+                    urgent = false;
+                    p += h.size;
+                    avail -= h.size;
+                    continue;
+                }
+                urgent = urgent || shouldFlush(static_cast<LogLevel::value>(h.level));
+                if (h.kind == RecordKind::TEXT)
+                {
+                    _backend_text.append(body, h.len);
+                }
+                else
                 {
-                    break; // 没有更多完整行
+                    DeferredHead d;
+                    std::memcpy(&d, body, sizeof(d));
+                    _backend_msg.setCtimeNs(d.ctime)
+                        .setSite(d.site)
+                        .setTid(d.tid)
+                        .setLogger(_logger_name);
+                    d.render(_backend_msg.payloadBuffer(), d.site.fmt, body + sizeof(d));
+                    _formatter->format(_backend_text, _backend_msg);
                 }
-                line = nl + 1;
+                _batch_records.push_back(SinkRecord{_backend_text.size() - before,
+                                                    static_cast<LogLevel::value>(h.level), h.logger});
+                p += h.size;
+                avail -= h.size;
+                // 攒够一段就先交出去，拼接用的文本缓冲不会随突发涨到整个异步缓冲那么大
+                if (_backend_text.size() >= BATCH_TEXT_BYTES)
+                    flushBatch();
             }
-        };
+            flushBatch();
+            return urgent;
+        }
 
-        virtual void setMaxBufferSize(size_t max_size) override
+        // 以下均在后台线程调用
+        void syncSinks()
         {
-            if (_looper)
+            flushSinks();
+            _dirty.store(false, std::memory_order_relaxed);
+            _last_flush = std::chrono::steady_clock::now();
+        }
+        bool flushDue() const
+        {
+            int64_t ms = _flush_interval_ms.load(std::memory_order_relaxed);
+            return ms > 0 && std::chrono::steady_clock::now() - _last_flush >= std::chrono::milliseconds(ms);
+        }
+
+        void flushBatch()
+        {
+            if (!_batch_records.empty())
             {
-                _looper->setMaxBufferSize(max_size);
+                _dirty.store(true, std::memory_order_relaxed);
+                for (auto &sink : _sinks)
+                    sink->logBatch(_backend_text.data(), _backend_text.size(), _batch_records.data(), _batch_records.size());
             }
+            _backend_text.clear();
+            _batch_records.clear();
         }
 
         // void setAsyncBufferGrowth(size_t threshold, size_t increment)
@@ -222,7 +718,22 @@ namespace mylog
         // }
 
     private:
-        AsyncLooper::ptr _looper;
+        static constexpr size_t BATCH_TEXT_BYTES = 1024 * 1024; // 单次 logBatch 的文本量上限（约）
+        static constexpr std::chrono::milliseconds FLUSH_RETRY{100}; // flush() 检查标记是否被丢弃的间隔
+        LogMsg _backend_msg; // 只在后台线程使用
+        std::string _backend_text;       // 一批渲染好的文本
+        std::vector<SinkRecord> _batch_records; // 本批每条记录的长度/等级/日志器 id
+        size_t _reported_msgs = 0; // 已写过摘要的丢弃条数/字节数
+        size_t _reported_bytes = 0;
+        std::mutex _flush_mutex; // 保护下面两个序号
+        std::condition_variable _flush_cond;
+        uint64_t _flush_requested = 0; // 已发出的 flush() 序号
+        uint64_t _flush_done = 0;      // 后台已完成的最大序号
+        std::atomic<int64_t> _flush_interval_ms{0}; // flushEvery() 的间隔
+        std::atomic<bool> _dirty{false};             // 上次刷新之后有过写出（后台线程写，共享定时器读）
+        std::chrono::steady_clock::time_point _last_flush = std::chrono::steady_clock::now(); // 仅后台线程
+        bool _timed = false;                         // 登记过共享定时器
+        Looper::ptr _looper;           // 放在最后：最先析构，停止后台线程后其余成员才销毁
     };
 
     /*
@@ -266,6 +777,25 @@ namespace mylog
             /*默认常规格式 "[%d{%H:%M:%S}][%t][%c][%f:%l][%p]%T%m%n"*/
             _formatter = std::make_shared<Formatter>(pattern);
         };
+        // 编译期模式串：Pattern 是静态存储期的字符数组，非法模式串编译失败（见 StaticFormatter）
+        template <const char *Pattern>
+        void buildLoggerFormatter()
+        {
+            _formatter = std::make_shared<StaticFormatter<Pattern>>();
+        };
+
+        void buildLoggerFlushOn(LogLevel::value level)
+        {
+            /*默认 OFF：只有显式 flush() 或缓冲写满才刷新；设为 ERROR 则错误日志写出后立即刷新*/
+            _flush_level = level;
+        }
+
+        void buildLoggerFlushEvery(std::chrono::milliseconds interval)
+        {
+            /*默认关闭：数据只在 ofstream 缓冲写满、flush() 或 flushOn 时落盘；
+              开启后有写入时最多约 interval 就刷新一次*/
+            _flush_every = interval;
+        }
 
         template <typename SinkType, typename... Args>
         void buildLoggerSink(Args &&...args)
@@ -279,6 +809,64 @@ namespace mylog
         {
             _async_max_buf = max_bytes;
         }
+        void buildAsyncDeferred(bool enable = true)
+        {
+            /*默认关闭；开启后生产者只写调用点+原始参数，格式化在后台线程完成*/
+            _async_opts.deferred = enable;
+        }
+        void buildAsyncOverflowPolicy(OverflowPolicy policy,
+                                      std::chrono::milliseconds timeout = std::chrono::milliseconds(0),
+                                      LogLevel::value keep_level = LogLevel::value::WARN)
+        {
+            /*默认 BLOCK；timeout 仅用于 BLOCK_TIMEOUT，keep_level 仅用于 DROP_BELOW_LEVEL*/
+            _async_opts.overflow.policy = policy;
+            _async_opts.overflow.timeout = timeout;
+            _async_opts.overflow.keep_level = keep_level;
+        }
+        void buildAsyncWakeup(size_t bytes, size_t count, std::chrono::milliseconds max_latency)
+        {
+            /*默认关闭：消费者睡着时每条数据都会唤醒它；开启后攒够 bytes 字节或 count 条、
+              或第一条数据之后超过 max_latency 才处理，一批数据最多唤醒两次*/
+            _async_opts.wakeup.bytes = bytes;
+            _async_opts.wakeup.count = count;
+            _async_opts.wakeup.max_latency = max_latency;
+        }
+        void buildAsyncLooperType(LooperType type, size_t ring_size = 0)
+        {
+            /*默认互斥锁双缓冲；LOOPER_RING 为固定大小的无锁环，LOOPER_PER_THREAD 为每线程队列，
+              ring_size 是环/每条线程队列的大小（向上取整到 2 的幂），0 取默认值*/
+            _async_opts.looper = type;
+            _async_opts.ring_size = ring_size;
+        }
+        void buildAsyncBufferStorage(bool huge_pages, size_t prefault_bytes = 0)
+        {
+            /*缓冲区本身是按需缺页的 mmap 映射，扩容不拷贝；huge_pages 建议内核使用透明大页，
+              prefault_bytes 在创建日志器时就把这么多字节的页分配好，突发写入时不再缺页*/
+            _async_opts.storage.huge_pages = huge_pages;
+            _async_opts.storage.prefault = prefault_bytes;
+        }
+        void buildAsyncBufferShrink(size_t initial, size_t low_streak, std::chrono::milliseconds idle)
+        {
+            /*默认初始 64KB，连续 64 批低于容量 1/4 或空闲 5s 后收缩；
+              low_streak 与 idle 都为 0 时只扩不缩*/
+            _async_opts.shrink.initial = initial;
+            _async_opts.shrink.low_streak = low_streak;
+            _async_opts.shrink.idle = idle;
+        }
+        void buildAsyncBufferPool(size_t buffer_bytes, size_t budget_bytes)
+        {
+            /*默认双缓冲、单块按需扩容；开启后缓冲区固定为 buffer_bytes，写满一块换下一块，
+              总量不超过 budget_bytes（至少 2 块），此时 buildAsyncBufferMax 不再生效*/
+            _async_opts.pool.buffer_size = buffer_bytes;
+            _async_opts.pool.budget = budget_bytes;
+        }
+        void buildAsyncSharedPool(size_t threads = 0)
+        {
+            /*不再每个日志器一条后台线程，改由进程内共享的线程池处理；
+              threads 为池的最少线程数（只增不减，多个日志器取最大值），0 取默认值*/
+            _async_opts.looper = LooperType::LOOPER_SHARED_POOL;
+            _async_opts.pool_threads = threads;
+        }
         // void buildAsyncBufferGrowth(size_t threshold, size_t increment)
         // {
         //     _async_threshold = threshold;
@@ -291,10 +879,13 @@ namespace mylog
         LoggerType _logger_type;
         std::string _logger_name;
         std::atomic<LogLevel::value> _limit_value;
+        LogLevel::value _flush_level = LogLevel::value::OFF;
+        std::chrono::milliseconds _flush_every{0};
         Formatter::ptr _formatter;
         std::vector<LogSink::ptr> _sinks;
 
         size_t _async_max_buf = 200 * 1024 * 1024;
+        AsyncOptions _async_opts;
         // size_t _async_threshold = THRESHOLD_BUFFER_SIZE; // 可选：若你愿意开放
         // size_t _async_increment = INCREMENT_BUFFER_SIZE; // 可选：若你愿意开放
     };
@@ -318,18 +909,26 @@ namespace mylog
 
             if (_logger_type == LoggerType::LOGGER_SYNC)
             {
-                return std::make_shared<SyncLogger>(_logger_name,
-                                                    _limit_value,
-                                                    _formatter,
-                                                    _sinks);
+                auto logger = std::make_shared<SyncLogger>(_logger_name,
+                                                           _limit_value,
+                                                           _formatter,
+                                                           _sinks);
+                logger->flushOn(_flush_level);
+                if (_flush_every.count() > 0)
+                    logger->flushEvery(_flush_every);
+                return logger;
             }
             else
             {
                 auto logger = std::make_shared<AsyncLogger>(_logger_name,
                                                             _limit_value,
                                                             _formatter,
-                                                            _sinks);
+                                                            _sinks,
+                                                            _async_opts);
                 logger->setMaxBufferSize(_async_max_buf);
+                logger->flushOn(_flush_level);
+                if (_flush_every.count() > 0)
+                    logger->flushEvery(_flush_every);
                 // 如果你想进一步开放阈值/增量（需要在 AsyncLooper/Buffer 暴露对应方法）
                 // logger->setBufferGrowth(_async_threshold, _async_increment);
                 return logger;
@@ -435,13 +1034,16 @@ namespace mylog
             Logger::ptr lp;
             if (_logger_type == LoggerType::LOGGER_ASYNC)
             {
-                lp = std::make_shared<AsyncLogger>(_logger_name, _limit_value, _formatter, _sinks);
+                lp = std::make_shared<AsyncLogger>(_logger_name, _limit_value, _formatter, _sinks, _async_opts);
                 lp->setMaxBufferSize(_async_max_buf); // ← 补上这一行
             }
             else
             {
                 lp = std::make_shared<SyncLogger>(_logger_name, _limit_value, _formatter, _sinks);
             }
+            lp->flushOn(_flush_level);
+            if (_flush_every.count() > 0)
+                lp->flushEvery(_flush_every);
 
             LoggerManager::getInstance().addLogger(_logger_name, lp);
             return lp;
@@ -2,23 +2,204 @@
 #pragma once
 
 #include "buffer.hpp"
+#include "level.hpp"
+#include "util.hpp"
 #include <thread>
 #include <mutex>
 #include <condition_variable>
 #include <functional>
 #include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <vector>
 
 namespace mylog
 {
     using Functor = std::function<void(Buffer &buffer)>;
+    // 就地写入回调：把一条记录直接写到 dst（已预留 cap 字节），返回记录的实际长度；返回值大于 cap 表示预留不够，调用方放弃本次写入
+    using InPlaceWriter = size_t (*)(char *dst, size_t cap, void *ctx);
 
-    class AsyncLooper
+    // 异步工作器的实现方式
+    enum class LooperType
+    {
+        LOOPER_MUTEX,     // 互斥锁 + 双缓冲（默认）
+        LOOPER_RING,      // 无锁多生产者单消费者环形缓冲
+        LOOPER_PER_THREAD, // 每个生产者线程一条队列，后台按时间戳归并
+        LOOPER_SHARED_POOL // 不单独开线程，由进程内共享的后台线程池处理
+    };
+
+    // 缓冲区写满时对生产者的处理方式
+    enum class OverflowPolicy
+    {
+        BLOCK,           // 阻塞等待（默认）
+        BLOCK_TIMEOUT,   // 最多阻塞 timeout，超时丢弃本条
+        DROP_NEWEST,     // 直接丢弃本条
+        DROP_OLDEST,     // 丢弃缓冲区中最早的记录腾出空间（无锁实现与共享线程池退化为 DROP_NEWEST）
+        DROP_BELOW_LEVEL // 低于 keep_level 的丢弃，其余阻塞等待
+    };
+
+    struct OverflowConfig
+    {
+        OverflowPolicy policy = OverflowPolicy::BLOCK;
+        std::chrono::milliseconds timeout{0};               // BLOCK_TIMEOUT
+        LogLevel::value keep_level = LogLevel::value::WARN; // DROP_BELOW_LEVEL
+    };
+
+    // 消费者唤醒的批量化设置（仅 LOOPER_MUTEX）：bytes/count 任一非 0 且 max_latency > 0 时生效
+    struct WakeupConfig
+    {
+        size_t bytes = 0;                         // 攒够这么多字节才唤醒
+        size_t count = 0;                         // 或攒够这么多条
+        std::chrono::milliseconds max_latency{0}; // 第一条数据之后最多等待这么久
+        bool every_push = false;                  // 每条写入都通知（改造前的行为，仅供基准对比）
+        bool batching() const { return (bytes || count) && max_latency.count() > 0; }
+    };
+
+    // 缓冲区的弹性收缩（仅 LOOPER_MUTEX）：突发过后把两块缓冲区缩回去，内存归还给系统
+    //   1.连续 low_streak 批数据都低于容量的 1/4（低水位），收缩到这些批次峰值的 2 倍
+    //   2.或者空闲超过 idle，收缩到 initial
+    //   只有目标容量不到当前容量的一半才收缩，扩容（写满）与收缩（低于 1/4）之间留有余量，避免反复抖动
+    struct ShrinkConfig
+    {
+        size_t initial = 64 * 1024;           // 初始容量，也是收缩的下限
+        size_t low_streak = 64;               // 0 表示不按低水位收缩
+        std::chrono::milliseconds idle{5000}; // 0 表示不按空闲收缩
+    };
+
+    // 多缓冲池（仅 LOOPER_MUTEX）：buffer_size 非 0 时生效
+    //   缓冲区固定为 buffer_size 字节，生产者写满一块就把它排进待消费队列、换一块空闲的继续写；
+    //   缓冲区总数不超过 budget / buffer_size（至少 2 块），预算用完才按溢出策略处理
+    struct BufferPoolConfig
+    {
+        size_t buffer_size = 0;
+        size_t budget = 0;
+        bool enabled() const { return buffer_size > 0; }
+        size_t limit() const { return std::max<size_t>(2, budget / std::max<size_t>(1, buffer_size)); }
+    };
+
+    // 异步工作器接口：生产者 push，后台线程把攒下的数据以 Buffer 的形式交给回调
+    class Looper
+    {
+    public:
+        using ptr = std::shared_ptr<Looper>;
+        explicit Looper(const OverflowConfig &overflow = OverflowConfig()) : _overflow(overflow) {}
+        virtual ~Looper() = default;
+        // level 仅用于溢出策略的判断；OFF 表示控制记录，不受丢弃类策略影响
+        virtual void push(const char *data, size_t len, LogLevel::value level) = 0;
+        virtual void stop() = 0;
+        virtual void setMaxBufferSize(size_t max_size) = 0;
+        // 在生产缓冲区中预留 reserve 字节，持锁调用 writer 直接写入，省掉一次拷贝；
+        // 不支持、空间不足或预留不够时返回 false，调用方回退到 push()（溢出策略只在 push() 中处理）
+        virtual bool pushInPlace(size_t reserve, LogLevel::value level, InPlaceWriter writer, void *ctx)
+        {
+            (void)reserve;
+            (void)level;
+            (void)writer;
+            (void)ctx;
+            return false;
+        }
+        // 生产者为即将写入的记录取时间戳（也就是落地时打印的时间），随后必须在同一线程调用 push()；
+        // 需要按时间戳归并的实现借此知道哪些线程有记录在途
+        virtual uint64_t stamp() { return util::Date::nowNs(); }
+        // 空闲定时：后台线程处理完数据后若空闲了 interval，就用空 Buffer 调用一次回调（周期性刷新落地用），
+        // 0 表示关闭；没有自己后台线程的实现返回 false，由调用方另行定时
+        virtual bool setTickInterval(std::chrono::milliseconds interval)
+        {
+            (void)interval;
+            return false;
+        }
+
+        // 因溢出策略被丢弃的累计条数/字节数
+        size_t droppedMessages() const { return _dropped_msgs.load(std::memory_order_relaxed); }
+        size_t droppedBytes() const { return _dropped_bytes.load(std::memory_order_relaxed); }
+        // 生产者/停止流程主动唤醒消费者的次数（每次都可能是一次 futex 系统调用）
+        size_t wakeups() const { return _wakeups.load(std::memory_order_relaxed); }
+
+    protected:
+        using Clock = std::chrono::steady_clock;
+
+        // 空间不足时的截止时刻，只有 BLOCK_TIMEOUT 才有意义
+        Clock::time_point overflowDeadline() const
+        {
+            if (_overflow.policy == OverflowPolicy::BLOCK_TIMEOUT)
+                return Clock::now() + _overflow.timeout;
+            return Clock::time_point::max();
+        }
+        // 空间不足时：true 继续等待，false 丢弃本条
+        // 等级为 OFF 的是控制记录（flush 标记），任何策略下都等待而不丢弃
+        bool keepWaiting(LogLevel::value level, Clock::time_point deadline) const
+        {
+            if (level == LogLevel::value::OFF)
+                return true;
+            switch (_overflow.policy)
+            {
+            case OverflowPolicy::BLOCK:
+                return true;
+            case OverflowPolicy::BLOCK_TIMEOUT:
+                return Clock::now() < deadline;
+            case OverflowPolicy::DROP_BELOW_LEVEL:
+                return level >= _overflow.keep_level;
+            default:
+                return false;
+            }
+        }
+        void countDrop(size_t msgs, size_t bytes)
+        {
+            _dropped_msgs.fetch_add(msgs, std::memory_order_relaxed);
+            _dropped_bytes.fetch_add(bytes, std::memory_order_relaxed);
+        }
+        void countWakeup() { _wakeups.fetch_add(1, std::memory_order_relaxed); }
+
+        // 空闲定时的记账，只在后台线程调用：处理完一批数据后开始计时，到期前又来了数据也不重新计时，
+        // 保证数据最多停留约一个 interval
+        void armTick()
+        {
+            int64_t ms = _tick_ms.load(std::memory_order_relaxed);
+            if (ms <= 0 || _tick_armed)
+                return;
+            _tick_armed = true;
+            _tick_due = Clock::now() + std::chrono::milliseconds(ms);
+        }
+        bool tickArmed() const { return _tick_armed; }
+        Clock::time_point tickDue() const { return _tick_due; }
+        // 到期后用空 Buffer 调用一次回调
+        void fireTick(const Functor &callback, Buffer &empty)
+        {
+            _tick_armed = false;
+            if (callback)
+                callback(empty);
+        }
+
+        const OverflowConfig _overflow;
+        std::atomic<int64_t> _tick_ms{0}; // setTickInterval() 设置的间隔（毫秒）
+
+    private:
+        bool _tick_armed = false;
+        Clock::time_point _tick_due;
+        std::atomic<size_t> _dropped_msgs{0};
+        std::atomic<size_t> _dropped_bytes{0};
+        std::atomic<size_t> _wakeups{0};
+    };
+
+    class AsyncLooper : public Looper
     {
     public:
         using ptr = std::shared_ptr<AsyncLooper>;
-        AsyncLooper(const Functor &callback)
-            : _running(true),
+        AsyncLooper(const Functor &callback, const OverflowConfig &overflow = OverflowConfig(),
+                    const WakeupConfig &wakeup = WakeupConfig(), const StorageConfig &storage = StorageConfig(),
+                    const ShrinkConfig &shrink = ShrinkConfig(), const BufferPoolConfig &pool = BufferPoolConfig())
+            : Looper(overflow),
               _callBack(callback),
+              _running(true),
+              _pro_buf(pool.enabled() ? pool.buffer_size : 200 * 1024 * 1024, pool.enabled() ? pool.buffer_size : shrink.initial, storage),
+              _con_buf(pool.enabled() ? pool.buffer_size : 200 * 1024 * 1024, pool.enabled() ? pool.buffer_size : shrink.initial, storage),
+              _pool(pool),
+              _storage(storage),
+              _wakeup(wakeup),
+              _shrink(shrink),
+              _min_capacity(std::max(shrink.initial, storage.prefault)),
               _thread(&AsyncLooper::threadEntry, this) {}
 
         ~AsyncLooper()
@@ -32,7 +213,7 @@ namespace mylog
             _cond_con.notify_one();
         }
 
-        void stop()
+        virtual void stop() override
         {
             // 解决：二次join造成导致 std::terminate
             bool expected = true;
@@ -44,6 +225,7 @@ namespace mylog
             {
                 // 如果 push() 正在 wait，stop() 只唤醒了 _cond_con，生产者可能仍卡在 _cond_pro 上。
                 std::lock_guard<std::mutex> lk(_mutex);
+                countWakeup();
                 _cond_pro.notify_all(); // 也唤醒生产者
                 _cond_con.notify_all(); // 唤醒消费者
             }
@@ -51,23 +233,88 @@ namespace mylog
                 _thread.join();
         }
 
-        void push(const char *data, size_t len)
+        virtual void push(const char *data, size_t len, LogLevel::value level) override
         {
-            // 既支持扩容，也在空间不足时能阻塞等待；stop() 会 notify_all 让这里退出。
+            // 既支持扩容，也在空间不足时按溢出策略等待或丢弃；stop() 会 notify_all 让这里退出。
             std::unique_lock<std::mutex> lock(_mutex);
+            if (_pool.enabled() && len > _pool.buffer_size)
+            {
+                countDrop(1, len); // 池模式下缓冲区大小固定，比一整块还大的记录放不下
+                return;
+            }
+            bool full = false;
+            Clock::time_point deadline;
             while (_running)
             {
                 if (_pro_buf.push(data, len))
                 {                           // 先尝试扩容+写入
-                    _cond_con.notify_one(); // 通知消费者有数据
+                    pushed(len);
                     return;
                 }
-                _cond_pro.wait(lock); // 仍然写不进去就等消费者释放
+                if (rotate())
+                    continue; // 池模式：换了一块空闲缓冲区，重试
+                if (!full)
+                {
+                    full = true;
+                    deadline = overflowDeadline();
+                }
+                if (_overflow.policy == OverflowPolicy::DROP_OLDEST && level != LogLevel::value::OFF)
+                {
+                    if (!dropOldest(len))
+                    {
+                        countDrop(1, len); // 缓冲区里已经没有可丢的旧记录，本条本身放不下
+                        return;
+                    }
+                    continue;
+                }
+                if (!keepWaiting(level, deadline))
+                {
+                    countDrop(1, len);
+                    return;
+                }
+                if (_con_sleeping)
+                {
+                    // 缓冲区已满，不必再等批量凑齐
+                    _con_sleeping = false;
+                    countWakeup();
+                    _cond_con.notify_one();
+                }
+                _pro_waiters++;
+                if (_overflow.policy == OverflowPolicy::BLOCK_TIMEOUT)
+                    _cond_pro.wait_until(lock, deadline);
+                else
+                    _cond_pro.wait(lock); // 仍然写不进去就等消费者释放
+                _pro_waiters--;
             }
         }
 
-        void setMaxBufferSize(size_t max_size)
+        virtual bool pushInPlace(size_t reserve, LogLevel::value level, InPlaceWriter writer, void *ctx) override
+        {
+            (void)level;
+            std::lock_guard<std::mutex> lk(_mutex);
+            if (!_running)
+                return false;
+            char *dst = _pro_buf.reserve(reserve);
+            if (!dst)
+                return false; // 空间不足：交给 push() 按溢出策略处理
+            size_t len = writer(dst, reserve, ctx);
+            if (len > reserve)
+                return false; // 预留不够，什么也没提交
+            _pro_buf.commit(len);
+            pushed(len);
+            return true;
+        }
+
+        virtual bool setTickInterval(std::chrono::milliseconds interval) override
+        {
+            _tick_ms.store(interval.count(), std::memory_order_relaxed);
+            return true;
+        }
+
+        virtual void setMaxBufferSize(size_t max_size) override
         {
+            if (_pool.enabled())
+                return; // 池模式下单块大小固定，总量由预算约束
             std::lock_guard<std::mutex> lk(_mutex);
             _pro_buf.resize(max_size); // 调整上限（不强行收缩当前容量）
             _con_buf.resize(max_size);
@@ -90,34 +337,258 @@ namespace mylog
                     // 1.判断生产缓冲区有没有数据，有则交换，无则阻塞
                     std::unique_lock<std::mutex> lock(_mutex);
                     // 若当前缓冲区有数据或者running为真继续向下运行；反之阻塞休眠
-                    _cond_con.wait(lock, [&]
-                                   { return !_pro_buf.empty() || !_running; });
+                    auto ready = [&]
+                    { return !_pro_buf.empty() || !_filled.empty() || !_running; };
+                    while (!ready())
+                    {
+                        _con_sleeping = true; // 生产者只在这个标志为真时才通知
+                        // 定时已开始：最多睡到到期，仍没有数据就用空 Buffer 回调一次（刷新落地）
+                        if (tickArmed())
+                        {
+                            if (!_cond_con.wait_until(lock, tickDue(), ready))
+                            {
+                                lock.unlock();
+                                fireTick(_callBack, _con_buf);
+                                lock.lock();
+                            }
+                            continue;
+                        }
+                        // 缓冲区还大着就只睡 idle 这么久，超时仍没有数据则收缩后再继续睡
+                        if (_shrink.idle.count() > 0 && aboveMinimum())
+                        {
+                            if (!_cond_con.wait_for(lock, _shrink.idle, ready))
+                                shrinkBuffers(_min_capacity);
+                            continue;
+                        }
+                        _cond_con.wait(lock, ready);
+                    }
+                    // 批量模式：拿到第一条后再等一会儿，攒够一批或到达最大延迟再处理
+                    if (_wakeup.batching() && _running && !batchReady())
+                    {
+                        _con_sleeping = true;
+                        _cond_con.wait_for(lock, _wakeup.max_latency, [&]
+                                           { return batchReady() || !_running; });
+                    }
+                    _con_sleeping = false;
                     //运行已结束且生产缓冲区已无数据才可推出（否则可能导致缓冲区数据未写完就退出）
-                    if (!_running && _pro_buf.empty())
+                    if (!_running && _pro_buf.empty() && _filled.empty())
                     {
                         break;
                     }
-                    _con_buf.swap(_pro_buf);
-                    // 4.唤醒生产者
-                    _cond_pro.notify_all();
+                    if (!_filled.empty())
+                    {
+                        // 池模式：先处理最早写满的那块，换下来的空缓冲区放回空闲列表
+                        _con_buf.swap(*_filled.front().buf);
+                        _spare.push_back(std::move(_filled.front().buf));
+                        _filled.pop_front();
+                    }
+                    else
+                    {
+                        _con_buf.swap(_pro_buf);
+                        _pro_sizes.clear();
+                        _pro_msgs = 0;
+                    }
+                    // 4.唤醒生产者（只有因缓冲区满而等待的生产者才需要）
+                    if (_pro_waiters)
+                        _cond_pro.notify_all();
                 }
 
                 // 2.被唤醒后，对消费缓冲区的数据进行处理
+                size_t used = _con_buf.readableSize();
                 if (_callBack)
                 {
                     _callBack(_con_buf);
                 };
                 // 3.初始化消费缓冲区
                 _con_buf.reset();
+                checkLowWatermark(used);
+                armTick();
             }
         };
+
+        // 按低水位连续计数，满足条件时两块缓冲区一起收缩
+        void checkLowWatermark(size_t used)
+        {
+            if (!_shrink.low_streak)
+                return;
+            if (_pool.enabled())
+            {
+                trimSpares();
+                return;
+            }
+            if (used > _con_buf.capacity() / 4)
+            {
+                _low_batches = 0;
+                _low_peak = 0;
+                return;
+            }
+            _low_peak = std::max(_low_peak, used);
+            if (++_low_batches < _shrink.low_streak)
+                return;
+            size_t target = std::max(_min_capacity, _low_peak * 2);
+            _low_batches = 0;
+            _low_peak = 0;
+            std::lock_guard<std::mutex> lk(_mutex);
+            shrinkBuffers(target);
+        }
+
+        // 池模式：块大小固定，改为按块数收缩。连续 low_streak 批里空闲列表始终没有用到的那几块
+        // （期间空闲块数的最小值）释放掉；持续有写入、从不空闲时，突发时多分配的缓冲区也能还回去
+        void trimSpares()
+        {
+            std::lock_guard<std::mutex> lk(_mutex);
+            _spare_low = std::min(_spare_low, _spare.size());
+            if (++_low_batches < _shrink.low_streak)
+                return;
+            // 空闲列表后进先出，前面的是最久没用过的
+            _spare.erase(_spare.begin(), _spare.begin() + _spare_low);
+            _pool_buffers -= _spare_low;
+            _low_batches = 0;
+            _spare_low = SIZE_MAX;
+        }
+
+        // 以下均在持有 _mutex 时调用
+        // 与 shrinkBuffers(_min_capacity) 的判断一致：只有真的能缩时才按空闲定时醒来，
+        // 否则容量落在 (下限, 2 倍下限] 之间时会每隔 idle 空转一次
+        bool aboveMinimum() const
+        {
+            if (_pool.enabled())
+                return !_spare.empty();
+            return _min_capacity < _pro_buf.capacity() / 2 || _min_capacity < _con_buf.capacity() / 2;
+        }
+        // 目标不到当前容量的一半才收缩；生产缓冲区里已有的数据会保留
+        // 池模式下单块大小固定，改为释放空闲列表里的缓冲区
+        void shrinkBuffers(size_t target)
+        {
+            if (_pool.enabled())
+            {
+                _pool_buffers -= _spare.size();
+                _spare.clear();
+                return;
+            }
+            for (Buffer *buf : {&_pro_buf, &_con_buf})
+            {
+                if (target < buf->capacity() / 2)
+                    buf->shrinkTo(target);
+            }
+        }
+        // 一条记录写入生产缓冲区之后的记账与唤醒
+        void pushed(size_t len)
+        {
+            if (_overflow.policy == OverflowPolicy::DROP_OLDEST)
+                _pro_sizes.push_back(len);
+            _pro_msgs++;
+            if (_wakeup.every_push)
+            {
+                countWakeup();
+                _cond_con.notify_one();
+                return;
+            }
+            // 只在消费者睡着时才通知；批量模式下只在第一条数据和攒够一批时通知
+            if (_con_sleeping && (!_wakeup.batching() || _pro_msgs == 1 || batchReady()))
+            {
+                _con_sleeping = false; // 已经叫过了，后续写入不必重复通知
+                countWakeup();
+                _cond_con.notify_one();
+            }
+        }
+
+        bool batchReady() const
+        {
+            return (_wakeup.bytes && _pro_buf.readableSize() >= _wakeup.bytes) ||
+                   (_wakeup.count && _pro_msgs >= _wakeup.count) || _pro_waiters > 0 || !_filled.empty();
+        }
+
+        // 池模式：把写满的生产缓冲区排进待消费队列，换上一块空闲的（没有则在预算内新建）；预算用完返回 false
+        bool rotate()
+        {
+            if (!_pool.enabled() || _pro_buf.empty())
+                return false;
+            std::unique_ptr<Buffer> next;
+            if (!_spare.empty())
+            {
+                next = std::move(_spare.back());
+                _spare.pop_back();
+                _spare_low = std::min(_spare_low, _spare.size());
+            }
+            else if (_pool_buffers < _pool.limit())
+            {
+                next = std::make_unique<Buffer>(_pool.buffer_size, _pool.buffer_size, _storage);
+                _pool_buffers++;
+            }
+            else
+            {
+                return false;
+            }
+            next->swap(_pro_buf);
+            _filled.push_back(Filled{std::move(next), _pro_msgs});
+            _pro_sizes.clear();
+            _pro_msgs = 0;
+            if (_con_sleeping)
+            {
+                _con_sleeping = false;
+                countWakeup();
+                _cond_con.notify_one();
+            }
+            return true;
+        }
+
+        // DROP_OLDEST：从生产缓冲区头部丢掉至少 need 字节（至少四分之一）的旧记录，批量丢弃以摊薄搬移开销
+        // 池模式下直接丢掉最早写满的一整块，腾出的缓冲区随即可用
+        bool dropOldest(size_t need)
+        {
+            if (!_filled.empty())
+            {
+                Filled oldest = std::move(_filled.front());
+                _filled.pop_front();
+                countDrop(oldest.msgs, oldest.buf->readableSize());
+                oldest.buf->reset();
+                _spare.push_back(std::move(oldest.buf));
+                return true;
+            }
+            if (_pro_sizes.empty())
+                return false;
+            size_t target = std::max(need, _pro_buf.readableSize() / 4);
+            size_t bytes = 0, msgs = 0;
+            while (bytes < target && !_pro_sizes.empty())
+            {
+                bytes += _pro_sizes.front();
+                _pro_sizes.pop_front();
+                msgs++;
+            }
+            _pro_buf.discardFront(bytes);
+            countDrop(msgs, bytes);
+            return true;
+        }
+
         Functor _callBack; // 由异步工作器的使用者传入对应buffer
 
     private:
+        struct Filled
+        {
+            std::unique_ptr<Buffer> buf;
+            size_t msgs; // 其中的记录条数（DROP_OLDEST 计数用）
+        };
+
         std::atomic<bool> _running;        // 工作标志
         Buffer _pro_buf;                   // 生产缓冲区
         Buffer _con_buf;                   // 消费缓冲区
+        const BufferPoolConfig _pool;
+        const StorageConfig _storage;
+        std::deque<Filled> _filled;                  // 池模式：已写满、等待消费的缓冲区（先进先出）
+        std::vector<std::unique_ptr<Buffer>> _spare; // 池模式：空闲缓冲区
+        size_t _pool_buffers = 2;                    // 池模式：已分配的缓冲区总数（含生产/消费缓冲区）
         std::mutex _mutex;                 // 互斥锁
+        std::deque<size_t> _pro_sizes;     // DROP_OLDEST：生产缓冲区中每条记录的长度
+        size_t _pro_msgs = 0;              // 生产缓冲区中的记录条数
+        size_t _pro_waiters = 0;           // 因缓冲区满而等待的生产者数
+        bool _con_sleeping = false;        // 消费者正在等待且尚未被通知
+        const WakeupConfig _wakeup;
+        const ShrinkConfig _shrink;
+        const size_t _min_capacity;        // 收缩的下限：不小于初始容量与预先缺页的大小
+        size_t _low_batches = 0;           // 连续低水位的批数（仅消费者线程）
+        size_t _low_peak = 0;              // 这些批次里最大的一批
+        size_t _spare_low = SIZE_MAX;      // 池模式：这些批次里空闲列表的最少块数
         std::condition_variable _cond_pro; // 生产者条件变量
         std::condition_variable _cond_con; // 消费者条件变量
         std::thread _thread;               // 异步工作器对应的工作线程
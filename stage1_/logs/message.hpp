@@ -2,34 +2,62 @@
 
 #include <iostream>
 #include <string>
+#include <string_view>
 #include <thread>
 #include "level.hpp"
 #include "util.hpp"
 
 namespace mylog
 {
+    // 调用点描述符：由宏为每个调用点生成一个静态实例，每条日志只引用它而不再拷贝 file/fmt
+    struct LogSite
+    {
+        constexpr LogSite() : file(), line(0), level(LogLevel::value::UNKNOW), fmt("") {}
+        constexpr LogSite(const char *f, size_t l, LogLevel::value lv, const char *fm)
+            : file(f), line(l), level(lv), fmt(fm) {}
+
+        std::string_view file; // 静态存储期（__FILE__）
+        size_t line;
+        LogLevel::value level;
+        const char *fmt; // 静态存储期（字符串字面量）
+    };
+
+    // 格式串不是字面量（运行期得到的 const char* 等）时宏生成的调用点：fmt 只在本次调用内有效，
+    // 日志器收到它时立即格式化，不走延迟格式化
+    struct RuntimeSite
+    {
+        LogSite site;
+    };
+
     struct LogMsg
     {
 
-        LogMsg() : _ctime(util::Date::now()), _tid(std::this_thread::get_id()) {}
+        LogMsg() : _ctime(util::Date::nowNs()), _line(0), _level(LogLevel::value::INFO), _tid(std::this_thread::get_id()) {}
 
-        LogMsg(std::string logger, std::string file, size_t line,
+        // file / logger 只保存视图，调用方需保证其生命周期覆盖本消息的使用
+        LogMsg(std::string_view logger, std::string_view file, size_t line,
                std::string payload, LogLevel::value level = LogLevel::value::INFO)
-            : _ctime(util::Date::now()), _line(line), _level(level), _tid(std::this_thread::get_id()), _file(std::move(file)), _logger(std::move(logger)), _payload(std::move(payload)) {}
+            : _ctime(util::Date::nowNs()), _line(line), _level(level), _tid(std::this_thread::get_id()), _file(file), _logger(logger), _payload(std::move(payload)) {}
 
         // ---------- getters ----------
-        time_t getCtime() const noexcept { return _ctime; }
+        time_t getCtime() const noexcept { return static_cast<time_t>(_ctime / 1000000000ull); }
+        uint64_t getCtimeNs() const noexcept { return _ctime; }
         size_t getLine() const noexcept { return _line; }
         LogLevel::value getLevel() const noexcept { return _level; }
         std::thread::id getTid() const noexcept { return _tid; }
-        const std::string &getFile() const noexcept { return _file; }
-        const std::string &getLogger() const noexcept { return _logger; }
+        std::string_view getFile() const noexcept { return _file; }
+        std::string_view getLogger() const noexcept { return _logger; }
         const std::string &getPayload() const noexcept { return _payload; }
 
         // ---------- setters（链式返回 *this） ----------
         LogMsg &setCtime(time_t t)
         {
-            _ctime = t;
+            _ctime = static_cast<uint64_t>(t) * 1000000000ull;
+            return *this;
+        }
+        LogMsg &setCtimeNs(uint64_t ns)
+        {
+            _ctime = ns;
             return *this;
         }
         LogMsg &setLine(size_t l)
@@ -53,25 +81,22 @@ namespace mylog
             return *this;
         }
 
-        LogMsg &setFile(std::string v)
-        {
-            _file = std::move(v);
-            return *this;
-        }
-        LogMsg &setFile(const char *v)
+        // 以下两个 setter 不拷贝字符串，只引用
+        LogMsg &setFile(std::string_view v)
         {
             _file = v;
             return *this;
         }
-
-        LogMsg &setLogger(std::string v)
+        LogMsg &setLogger(std::string_view v)
         {
-            _logger = std::move(v);
+            _logger = v;
             return *this;
         }
-        LogMsg &setLogger(const char *v)
+        LogMsg &setSite(const LogSite &site)
         {
-            _logger = v;
+            _file = site.file;
+            _line = site.line;
+            _level = site.level;
             return *this;
         }
 
@@ -85,15 +110,17 @@ namespace mylog
             _payload = v;
             return *this;
         }
+        // 直接在消息体上格式化（复用其已有容量）
+        std::string &payloadBuffer() noexcept { return _payload; }
 
     private:
-        time_t _ctime;          // 日志产生时间戳
+        uint64_t _ctime;        // 日志产生时间戳（纳秒，来源见 util::ClockSource）
         size_t _line;           // 错误发生行号
         LogLevel::value _level; // 日志等级
         std::thread::id _tid;   // 线程ID
-        std::string _file;      // 错误产生的源码文件名
-        std::string _logger;    // 日志器名称
-        std::string _payload;   // 实际错误信息
+        std::string_view _file;   // 错误产生的源码文件名（引用调用点描述符）
+        std::string_view _logger; // 日志器名称（引用日志器自身保存的名称）
+        std::string _payload;     // 实际错误信息（唯一随每条日志变化的部分）
     };
 }
 
@@ -1,5 +1,7 @@
 #pragma once
 #include "logger.hpp"
+#include <type_traits>
+#include <utility>
 namespace mylog
 {
 
@@ -12,18 +14,106 @@ namespace mylog
     {
         return LoggerManager::getInstance().rootLogger();
     }
+    namespace details
+    {
+        // 只在宏的不可达分支里出现，借编译器的 printf 检查在编译期校验格式串与参数
+        inline void checkFormat(const char *, ...) __attribute__((format(printf, 1, 2)));
+        inline void checkFormat(const char *, ...) {}
+        // std::string 格式串没有编译期检查可做（与原来的 va_list 接口一致）
+        template <typename S, typename... Args,
+                  typename std::enable_if<std::is_same<typename std::decay<S>::type, std::string>::value, int>::type = 0>
+        inline void checkFormat(const S &, const Args &...) {}
+
+        // 字符串字面量的类型是 const char (&)[N]；其余（const char* 变量、char 数组、std::string 等）都按运行期格式串处理
+        template <typename T>
+        struct IsFmtLiteral : std::false_type
+        {
+        };
+        template <size_t N>
+        struct IsFmtLiteral<const char (&)[N]> : std::true_type
+        {
+        };
+        // 让字面量分支的初始化依赖模板参数：格式串不是字面量时这一分支不会被实例化
+        template <typename Tag, typename T>
+        constexpr T &&literalFmt(Tag, T &&fmt) { return std::forward<T>(fmt); }
+        inline const char *fmtPtr(const char *fmt) { return fmt; }
+        inline const char *fmtPtr(const std::string &fmt) { return fmt.c_str(); } // 临时对象活到整条调用结束
+    }
+#define MYLOG_CHECK_FMT(fmt, ...) (false ? (::mylog::details::checkFormat(fmt, ##__VA_ARGS__), (fmt)) : (fmt))
+
+// 每个调用点生成一个静态的 LogSite（常量初始化，无运行期开销）；
+// fmt 不是字符串字面量时改为生成一个只在本次调用内有效的 RuntimeSite，由日志器立即格式化
+#define MYLOG_SITE(level, fmt, ...)                                                                              \
+    ((void)MYLOG_CHECK_FMT(fmt, ##__VA_ARGS__),                                                                  \
+     [&](auto _mylog_lit, auto &&_mylog_fmt) -> decltype(auto) {                                                 \
+         if constexpr (decltype(_mylog_lit)::value)                                                              \
+         {                                                                                                       \
+             static constexpr ::mylog::LogSite _mylog_site(__FILE__, __LINE__, level,                            \
+                                                           ::mylog::details::literalFmt(_mylog_lit, fmt));       \
+             return (_mylog_site);                                                                               \
+         }                                                                                                       \
+         else                                                                                                    \
+             return ::mylog::RuntimeSite{::mylog::LogSite(__FILE__, __LINE__, level,                             \
+                                                          ::mylog::details::fmtPtr(_mylog_fmt))};                \
+     }(std::integral_constant<bool, ::mylog::details::IsFmtLiteral<decltype((fmt))>::value>(), fmt))
+
 // 2.使用宏函数，对日志器接口进行代理（代理模式）
-#define debug(fmt, ...) debug(__FILE__, __LINE__, fmt, ##__VA_ARGS__)
-#define info(fmt, ...) info(__FILE__, __LINE__, fmt, ##__VA_ARGS__)
-#define warn(fmt, ...) warn(__FILE__, __LINE__, fmt, ##__VA_ARGS__)
-#define error(fmt, ...) error(__FILE__, __LINE__, fmt, ##__VA_ARGS__)
-#define fatal(fmt, ...) fatal(__FILE__, __LINE__, fmt, ##__VA_ARGS__)
-
-#define LOG_DEBUG(logger, fmt, ...) (logger)->debug(fmt, ##__VA_ARGS__)
-#define LOG_INFO(logger, fmt, ...) (logger)->info(fmt, ##__VA_ARGS__)
-#define LOG_WARN(logger, fmt, ...) (logger)->warn(fmt, ##__VA_ARGS__)
-#define LOG_ERROR(logger, fmt, ...) (logger)->error(fmt, ##__VA_ARGS__)
-#define LOG_FATAL(logger, fmt, ...) (logger)->fatal(fmt, ##__VA_ARGS__)
+#define debug(fmt, ...) debug(MYLOG_SITE(::mylog::LogLevel::value::DEBUG, fmt, ##__VA_ARGS__), ##__VA_ARGS__)
+#define info(fmt, ...) info(MYLOG_SITE(::mylog::LogLevel::value::INFO, fmt, ##__VA_ARGS__), ##__VA_ARGS__)
+#define warn(fmt, ...) warn(MYLOG_SITE(::mylog::LogLevel::value::WARN, fmt, ##__VA_ARGS__), ##__VA_ARGS__)
+#define error(fmt, ...) error(MYLOG_SITE(::mylog::LogLevel::value::ERROR, fmt, ##__VA_ARGS__), ##__VA_ARGS__)
+#define fatal(fmt, ...) fatal(MYLOG_SITE(::mylog::LogLevel::value::FATAL, fmt, ##__VA_ARGS__), ##__VA_ARGS__)
+
+// 编译期日志等级：低于 MYLOG_ACTIVE_LEVEL 的宏展开为空（参数不求值，只保留编译期格式检查）
+// 用法：g++ -DMYLOG_ACTIVE_LEVEL=MYLOG_LEVEL_INFO ...
+#define MYLOG_LEVEL_DEBUG 1
+#define MYLOG_LEVEL_INFO 2
+#define MYLOG_LEVEL_WARN 3
+#define MYLOG_LEVEL_ERROR 4
+#define MYLOG_LEVEL_FATAL 5
+#define MYLOG_LEVEL_OFF 6
+#ifndef MYLOG_ACTIVE_LEVEL
+#define MYLOG_ACTIVE_LEVEL MYLOG_LEVEL_DEBUG
+#endif
+    static_assert(MYLOG_LEVEL_DEBUG == static_cast<int>(LogLevel::value::DEBUG) &&
+                      MYLOG_LEVEL_OFF == static_cast<int>(LogLevel::value::OFF),
+                  "MYLOG_LEVEL_* 需与 LogLevel::value 保持一致");
+
+// 先读日志器的原子等级，通过后才求值参数并调用接口；
+// 整体仍是一个 void 表达式（logger 只求值一次），可以用在 cond ? LOG_INFO(...) : void() 或逗号表达式里
+#define MYLOG_LOG_IF(logger, level, method, fmt, ...)      \
+    ([&](auto &&_mylog_lp) -> void {                       \
+        if (_mylog_lp->shouldLog(level))                   \
+            _mylog_lp->method(fmt, ##__VA_ARGS__);         \
+    }(logger))
+#define MYLOG_LOG_NONE(fmt, ...) \
+    (false ? ::mylog::details::checkFormat(fmt, ##__VA_ARGS__) : void())
+
+#if MYLOG_ACTIVE_LEVEL <= MYLOG_LEVEL_DEBUG
+#define LOG_DEBUG(logger, fmt, ...) MYLOG_LOG_IF(logger, ::mylog::LogLevel::value::DEBUG, debug, fmt, ##__VA_ARGS__)
+#else
+#define LOG_DEBUG(logger, fmt, ...) MYLOG_LOG_NONE(fmt, ##__VA_ARGS__)
+#endif
+#if MYLOG_ACTIVE_LEVEL <= MYLOG_LEVEL_INFO
+#define LOG_INFO(logger, fmt, ...) MYLOG_LOG_IF(logger, ::mylog::LogLevel::value::INFO, info, fmt, ##__VA_ARGS__)
+#else
+#define LOG_INFO(logger, fmt, ...) MYLOG_LOG_NONE(fmt, ##__VA_ARGS__)
+#endif
+#if MYLOG_ACTIVE_LEVEL <= MYLOG_LEVEL_WARN
+#define LOG_WARN(logger, fmt, ...) MYLOG_LOG_IF(logger, ::mylog::LogLevel::value::WARN, warn, fmt, ##__VA_ARGS__)
+#else
+#define LOG_WARN(logger, fmt, ...) MYLOG_LOG_NONE(fmt, ##__VA_ARGS__)
+#endif
+#if MYLOG_ACTIVE_LEVEL <= MYLOG_LEVEL_ERROR
+#define LOG_ERROR(logger, fmt, ...) MYLOG_LOG_IF(logger, ::mylog::LogLevel::value::ERROR, error, fmt, ##__VA_ARGS__)
+#else
+#define LOG_ERROR(logger, fmt, ...) MYLOG_LOG_NONE(fmt, ##__VA_ARGS__)
+#endif
+#if MYLOG_ACTIVE_LEVEL <= MYLOG_LEVEL_FATAL
+#define LOG_FATAL(logger, fmt, ...) MYLOG_LOG_IF(logger, ::mylog::LogLevel::value::FATAL, fatal, fmt, ##__VA_ARGS__)
+#else
+#define LOG_FATAL(logger, fmt, ...) MYLOG_LOG_NONE(fmt, ##__VA_ARGS__)
+#endif
 
 // 3.提供宏函数，直接进行日志的标准输出打印（不用获取日志器）
 #define LOGD(fmt, ...) LOG_DEBUG(mylog::rootLogger(), fmt, ##__VA_ARGS__)
@@ -0,0 +1,216 @@
+/*共享后台线程池
+    1.进程内只有一个 LooperPool，若干工作线程服务所有挂在池上的异步日志器
+    2.每个日志器（PooledLooper）只持有一块生产缓冲区；有数据时把自己放进就绪队列，且同一时刻最多在队列中出现一次
+    3.工作线程取出一个日志器，交换缓冲区后处理一批数据；处理完若还有数据就排到队尾，保证各日志器轮流获得处理（公平）
+    4.同一个日志器同一时刻只会被一个工作线程处理，日志器内部的顺序不变
+*/
+#pragma once
+
+#include "looper.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace mylog
+{
+    inline constexpr size_t DEFAULT_POOL_THREADS = 2;
+    inline constexpr size_t POOLED_BUFFER_INITIAL = 64 * 1024; // 池化日志器的生产缓冲区初始大小，按需扩容
+
+    class PooledLooper;
+
+    class LooperPool
+    {
+    public:
+        // 故意不析构：进程退出时仍可能有日志器在析构中等待池把数据处理完
+        static LooperPool &getInstance()
+        {
+            static LooperPool *pool = new LooperPool();
+            return *pool;
+        }
+
+        // 工作线程数只增不减；threads 为 0 时保证至少有默认数量的线程
+        void ensureThreads(size_t threads)
+        {
+            std::lock_guard<std::mutex> lk(_mutex);
+            size_t want = threads ? threads : DEFAULT_POOL_THREADS;
+            while (_threads.size() < want)
+                _threads.emplace_back(&LooperPool::workerEntry, this);
+        }
+        size_t threadCount()
+        {
+            std::lock_guard<std::mutex> lk(_mutex);
+            return _threads.size();
+        }
+
+        // 由 PooledLooper 调用：把有数据的日志器放入就绪队列
+        void schedule(PooledLooper *looper)
+        {
+            {
+                std::lock_guard<std::mutex> lk(_mutex);
+                _ready.push_back(looper);
+            }
+            _cond.notify_one();
+        }
+
+    private:
+        LooperPool() = default;
+        LooperPool(const LooperPool &) = delete;
+        LooperPool &operator=(const LooperPool &) = delete;
+
+        void workerEntry();
+
+        std::mutex _mutex;
+        std::condition_variable _cond;
+        std::deque<PooledLooper *> _ready;
+        std::vector<std::thread> _threads;
+    };
+
+    class PooledLooper : public Looper
+    {
+    public:
+        using ptr = std::shared_ptr<PooledLooper>;
+        // threads 为池的最少线程数，0 表示使用默认值
+        PooledLooper(const Functor &callback, size_t threads = 0, const OverflowConfig &overflow = OverflowConfig(),
+                     const StorageConfig &storage = StorageConfig())
+            : Looper(overflow),
+              _callBack(callback),
+              _pro_buf(_max_size, POOLED_BUFFER_INITIAL, storage)
+        {
+            LooperPool::getInstance().ensureThreads(threads);
+        }
+
+        ~PooledLooper()
+        {
+            stop();
+        }
+
+        // 停止接收新数据，并等待池处理完本日志器已有的数据
+        virtual void stop() override
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _stopped = true;
+            _cond_pro.notify_all();
+            _cond_idle.wait(lock, [&]
+                            { return !_scheduled; });
+        }
+
+        // DROP_OLDEST 在池化模式下按 DROP_NEWEST 处理
+        virtual void push(const char *data, size_t len, LogLevel::value level) override
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            bool full = false;
+            Clock::time_point deadline;
+            while (!_stopped)
+            {
+                if (_pro_buf.push(data, len))
+                {
+                    pushed(lock);
+                    return;
+                }
+                if (!full)
+                {
+                    full = true;
+                    deadline = overflowDeadline();
+                }
+                if (!keepWaiting(level, deadline))
+                {
+                    countDrop(1, len);
+                    return;
+                }
+                if (_overflow.policy == OverflowPolicy::BLOCK_TIMEOUT)
+                    _cond_pro.wait_until(lock, deadline);
+                else
+                    _cond_pro.wait(lock);
+            }
+        }
+
+        virtual bool pushInPlace(size_t reserve, LogLevel::value level, InPlaceWriter writer, void *ctx) override
+        {
+            (void)level;
+            std::unique_lock<std::mutex> lock(_mutex);
+            if (_stopped)
+                return false;
+            char *dst = _pro_buf.reserve(reserve);
+            if (!dst)
+                return false;
+            size_t len = writer(dst, reserve, ctx);
+            if (len > reserve)
+                return false;
+            _pro_buf.commit(len);
+            pushed(lock);
+            return true;
+        }
+
+        virtual void setMaxBufferSize(size_t max_size) override
+        {
+            std::lock_guard<std::mutex> lk(_mutex);
+            _max_size = max_size;
+            _pro_buf.resize(max_size);
+        }
+
+        // 由池的工作线程调用：处理一批数据；返回 true 表示还有数据，需要重新排队
+        bool runOnce(Buffer &con_buf)
+        {
+            {
+                std::lock_guard<std::mutex> lk(_mutex);
+                con_buf.swap(_pro_buf);
+                _pro_buf.resize(_max_size); // swap 会交换上限，这里恢复本日志器自己的上限
+                _cond_pro.notify_all();
+            }
+            if (_callBack)
+                _callBack(con_buf);
+            con_buf.reset();
+
+            std::lock_guard<std::mutex> lk(_mutex);
+            if (!_pro_buf.empty())
+                return true;
+            _scheduled = false;
+            _cond_idle.notify_all();
+            return false;
+        }
+
+    private:
+        // 写入之后：尚未排队就放进池的就绪队列（会释放锁）
+        void pushed(std::unique_lock<std::mutex> &lock)
+        {
+            if (_scheduled)
+                return;
+            _scheduled = true;
+            lock.unlock();
+            countWakeup();
+            LooperPool::getInstance().schedule(this);
+        }
+
+        Functor _callBack;
+        size_t _max_size = 200 * 1024 * 1024;
+        Buffer _pro_buf;          // 只有生产缓冲区，消费缓冲区由工作线程提供
+        bool _scheduled = false;  // 已在就绪队列中或正在被处理
+        bool _stopped = false;
+        std::mutex _mutex;
+        std::condition_variable _cond_pro;
+        std::condition_variable _cond_idle;
+    };
+
+    inline void LooperPool::workerEntry()
+    {
+        Buffer con_buf(200 * 1024 * 1024, POOLED_BUFFER_INITIAL); // 每个工作线程一块消费缓冲区，与日志器的生产缓冲区轮换
+        while (1)
+        {
+            PooledLooper *looper;
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                _cond.wait(lock, [&]
+                           { return !_ready.empty(); });
+                looper = _ready.front();
+                _ready.pop_front();
+            }
+            // 每次只处理一批，还有数据就排到队尾，让其他日志器也能轮到
+            if (looper->runOnce(con_buf))
+                schedule(looper);
+        }
+    }
+}
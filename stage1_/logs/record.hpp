@@ -0,0 +1,178 @@
+/*异步缓冲区中的二进制日志记录
+    1.定长记录头 + 变长记录体，整条记录按 8 字节对齐
+    2.TEXT：记录体是已格式化好的日志文本（可以包含换行，整条记录原样交给落地）
+    3.DEFERRED：记录体是原始参数字节，格式化推迟到后台线程（NanoLog 式拆分）
+    4.记录头带长度、等级与日志器 id，后台按记录头逐条跳转，不再扫描换行
+    5.FLUSH：控制记录，记录体是 Logger::flush() 的序号；后台处理到它时刷新各落地方向并通知等待者
+*/
+#pragma once
+
+#include "level.hpp"
+#include "message.hpp"
+#include "util.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+
+namespace mylog
+{
+    enum class RecordKind : uint16_t
+    {
+        TEXT = 0,
+        DEFERRED,
+        FLUSH
+    };
+
+    struct RecordHeader
+    {
+        uint32_t size;   // 整条记录字节数（含头部与对齐填充）
+        uint32_t len;    // 记录体有效字节数
+        RecordKind kind; // 记录类型
+        uint16_t level;  // LogLevel::value
+        uint32_t logger; // 日志器 id（Logger::id()）
+    };
+
+    // 后台线程按调用点的参数类型把原始字节还原并格式化
+    using RenderFn = void (*)(std::string &out, const char *fmt, const char *args);
+
+    // DEFERRED 记录体的固定部分，其后紧跟编码后的参数
+    struct DeferredHead
+    {
+        uint64_t ctime; // 纳秒
+        std::thread::id tid;
+        LogSite site; // file/fmt 只保存指针，必须是静态存储期（__FILE__ / 字符串字面量）
+        RenderFn render;
+    };
+    static_assert(std::is_trivially_copyable<DeferredHead>::value, "DeferredHead 需要可按字节拷贝");
+
+    class Record
+    {
+    public:
+        static constexpr size_t ALIGN = 8;
+        static constexpr size_t alignUp(size_t n) { return (n + ALIGN - 1) & ~(ALIGN - 1); }
+        static constexpr size_t frameSize(size_t body) { return alignUp(sizeof(RecordHeader) + body); }
+
+        // 就地封装 TEXT 记录：beginText 先占住记录头，调用方把正文直接追加到 out 末尾，
+        // 再由 finishText 补齐对齐填充并写入记录头，正文不需要再拷贝一次
+        static size_t beginText(std::string &out)
+        {
+            size_t off = out.size();
+            out.resize(off + sizeof(RecordHeader));
+            return off;
+        }
+        static void finishText(std::string &out, size_t off, LogLevel::value level, uint32_t logger)
+        {
+            size_t len = out.size() - off - sizeof(RecordHeader);
+            out.resize(off + frameSize(len));
+            finishText(&out[off], len, level, logger);
+        }
+        // 同上，用于直接写在异步缓冲里的记录：rec 处已预留 frameSize(len) 字节，正文已写好
+        static void finishText(char *rec, size_t len, LogLevel::value level, uint32_t logger)
+        {
+            RecordHeader h{static_cast<uint32_t>(frameSize(len)), static_cast<uint32_t>(len),
+                           RecordKind::TEXT, static_cast<uint16_t>(level), logger};
+            std::memcpy(rec, &h, sizeof(h));
+            std::memset(rec + sizeof(h) + len, 0, frameSize(len) - sizeof(h) - len);
+        }
+
+        // 把一条 TEXT 记录追加到 out 末尾
+        static void appendText(std::string &out, LogLevel::value level, uint32_t logger, const char *data, size_t len)
+        {
+            size_t off = beginText(out);
+            out.append(data, len);
+            finishText(out, off, level, logger);
+        }
+
+        // 读取 data 处的记录头；剩余字节不足一条完整记录时返回 false
+        static bool peek(const char *data, size_t avail, RecordHeader &h)
+        {
+            if (avail < sizeof(RecordHeader))
+                return false;
+            std::memcpy(&h, data, sizeof(h));
+            return h.size >= sizeof(RecordHeader) && h.size <= avail;
+        }
+        static const char *body(const char *record) { return record + sizeof(RecordHeader); }
+    };
+
+    // 参数编解码：char 指针按字符串内容拷贝（生产者返回后原指针可能失效），其余类型按值拷贝字节
+    template <typename... Args>
+    class ArgCodec
+    {
+        template <typename T>
+        using isStr = std::integral_constant<bool, std::is_same<std::decay_t<T>, const char *>::value ||
+                                                       std::is_same<std::decay_t<T>, char *>::value>;
+
+        static const char *str(const char *v) { return v ? v : "(null)"; }
+
+        template <typename T>
+        static size_t sizeOf(const T &v)
+        {
+            if constexpr (isStr<T>::value)
+                return std::strlen(str(v)) + 1;
+            else
+                return sizeof(std::decay_t<T>);
+        }
+
+        template <typename T>
+        static char *put(char *dst, const T &v)
+        {
+            if constexpr (isStr<T>::value)
+            {
+                const char *s = str(v);
+                size_t n = std::strlen(s) + 1;
+                std::memcpy(dst, s, n);
+                return dst + n;
+            }
+            else
+            {
+                std::decay_t<T> tmp = v;
+                std::memcpy(dst, &tmp, sizeof(tmp));
+                return dst + sizeof(tmp);
+            }
+        }
+
+        template <typename T>
+        static T get(const char *&src)
+        {
+            if constexpr (isStr<T>::value)
+            {
+                const char *s = src;
+                src += std::strlen(s) + 1;
+                return const_cast<T>(s);
+            }
+            else
+            {
+                T v;
+                std::memcpy(&v, src, sizeof(T));
+                src += sizeof(T);
+                return v;
+            }
+        }
+
+    public:
+        static size_t encodedSize(const Args &...args)
+        {
+            return (size_t(0) + ... + sizeOf(args));
+        }
+
+        static void encode(char *dst, const Args &...args)
+        {
+            (void)dst;
+            ((dst = put(dst, args)), ...);
+        }
+
+        static void render(std::string &out, const char *fmt, const char *src)
+        {
+            (void)src;
+            // 花括号初始化保证按参数顺序依次解码
+            std::tuple<std::decay_t<Args>...> values{get<std::decay_t<Args>>(src)...};
+            std::apply([&](const auto &...v)
+                       { util::Printf::format(out, fmt, v...); },
+                       values);
+        }
+    };
+}
@@ -0,0 +1,303 @@
+/*无锁环形异步工作器（多生产者单消费者）
+    1.生产者用 fetch_add 在写游标上预留一段空间，写入数据后再原子地写记录头完成提交
+    2.消费者按位置顺序读取已提交的记录，拷进消费缓冲区后交给回调，随后清零已读区域并推进读游标
+    3.环满时生产者自旋/让出等待读游标前移；消费者空闲时在条件变量上休眠，生产者只在它睡着时才通知
+    4.非 BLOCK 的溢出策略改用 CAS 预留，空间不足时可以放弃；DROP_OLDEST 在这里等同于 DROP_NEWEST
+*/
+#pragma once
+
+#include "looper.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace mylog
+{
+    inline constexpr size_t DEFAULT_RING_SIZE = 8 * 1024 * 1024;
+
+    class RingLooper : public Looper
+    {
+    public:
+        using ptr = std::shared_ptr<RingLooper>;
+        // capacity 向上取整到 2 的幂，最小 4KB；0 表示默认大小
+        RingLooper(const Functor &callback, size_t capacity = DEFAULT_RING_SIZE,
+                   const OverflowConfig &overflow = OverflowConfig())
+            : Looper(overflow),
+              _callBack(callback),
+              _cap(roundCapacity(capacity ? capacity : DEFAULT_RING_SIZE)),
+              _ring(_cap / sizeof(uint64_t), 0),
+              _con_buf(_cap),
+              _running(true),
+              _thread(&RingLooper::threadEntry, this) {}
+
+        ~RingLooper()
+        {
+            stop();
+        }
+
+        virtual void stop() override
+        {
+            bool expected = true;
+            if (!_running.compare_exchange_strong(expected, false))
+            {
+                return;
+            }
+            wakeConsumer(true);
+            if (_thread.joinable())
+                _thread.join();
+        }
+
+        virtual void push(const char *data, size_t len, LogLevel::value level) override
+        {
+            if (!_running.load(std::memory_order_relaxed))
+            {
+                countDrop(1, len); // 已经停止，不再接收
+                return;
+            }
+            const uint64_t frame = frameSize(len);
+            if (frame > _cap)
+            {
+                countDrop(1, len); // 单条记录比整个环还大，放不下
+                return;
+            }
+
+            uint64_t pos;
+            if (_overflow.policy == OverflowPolicy::BLOCK)
+            {
+                // 1.预留：写游标只增不减，每个生产者拿到互不重叠的一段
+                pos = _tail.fetch_add(frame, std::memory_order_relaxed);
+                // 2.等待读游标前移到足够的位置（环满时才会等）
+                for (unsigned spin = 0; pos + frame - __atomic_load_n(&_head, __ATOMIC_ACQUIRE) > _cap; spin++)
+                {
+                    if (_exited.load(std::memory_order_acquire))
+                    {
+                        countDrop(1, len); // 消费者已退出，没人会再腾出空间
+                        return;
+                    }
+                    backoff(spin);
+                }
+            }
+            else if (!tryReserve(frame, len, level, pos))
+            {
+                return;
+            }
+            // 3.写数据，最后以 release 写记录头作为提交
+            copyIn(pos + HEADER_SIZE, data, len);
+            __atomic_store_n(headerAt(pos), (static_cast<uint64_t>(len) << 1) | 1, __ATOMIC_RELEASE);
+            std::atomic_thread_fence(std::memory_order_seq_cst); // 提交与读取 _sleeping/_running 不能乱序，否则可能漏掉唤醒
+            if (!_running.load(std::memory_order_relaxed))
+            {
+                // 与 stop() 并发：消费者可能在看到 _head == _tail 之后我们才预留，等它要么取走这条、要么已经退出
+                for (unsigned spin = 0; __atomic_load_n(&_head, __ATOMIC_ACQUIRE) <= pos && !_exited.load(std::memory_order_acquire); spin++)
+                    backoff(spin);
+                if (__atomic_load_n(&_head, __ATOMIC_ACQUIRE) <= pos)
+                    countDrop(1, len); // 消费者已退出，这条不会再被取走
+                return;
+            }
+            if (_sleeping.load(std::memory_order_relaxed) && _sleeping.exchange(false)) // 只由第一个看到的生产者去唤醒
+                wakeConsumer(false);
+        }
+
+        virtual bool setTickInterval(std::chrono::milliseconds interval) override
+        {
+            _tick_ms.store(interval.count(), std::memory_order_relaxed);
+            return true;
+        }
+
+        // 环的大小在构造时确定，这里只约束单次交给回调的数据量
+        virtual void setMaxBufferSize(size_t max_size) override
+        {
+            (void)max_size;
+        }
+
+    private:
+        static constexpr size_t HEADER_SIZE = sizeof(uint64_t);
+
+        static size_t roundCapacity(size_t n)
+        {
+            size_t cap = 4096;
+            while (cap < n)
+                cap <<= 1;
+            return cap;
+        }
+        static uint64_t frameSize(size_t len)
+        {
+            return (HEADER_SIZE + len + HEADER_SIZE - 1) & ~static_cast<uint64_t>(HEADER_SIZE - 1);
+        }
+
+        char *bytes() { return reinterpret_cast<char *>(_ring.data()); }
+        uint64_t *headerAt(uint64_t pos) { return &_ring[(pos & (_cap - 1)) / HEADER_SIZE]; }
+
+        // 按环形位置拷贝，可能跨越末尾
+        void copyIn(uint64_t pos, const char *data, size_t len)
+        {
+            size_t off = pos & (_cap - 1);
+            size_t first = std::min(len, _cap - off);
+            std::memcpy(bytes() + off, data, first);
+            std::memcpy(bytes(), data + first, len - first);
+        }
+        void copyOut(uint64_t pos, size_t len)
+        {
+            size_t off = pos & (_cap - 1);
+            size_t first = std::min(len, _cap - off);
+            _con_buf.push(bytes() + off, first);
+            _con_buf.push(bytes(), len - first);
+        }
+        // 读完后清零：之后的记录头可能落在这段旧数据上，必须保证未提交的位置读出来是 0
+        void zero(uint64_t pos, size_t len)
+        {
+            size_t off = pos & (_cap - 1);
+            size_t first = std::min(len, _cap - off);
+            std::memset(bytes() + off, 0, first);
+            std::memset(bytes(), 0, len - first);
+        }
+
+        void wakeConsumer(bool all)
+        {
+            std::lock_guard<std::mutex> lk(_mutex);
+            countWakeup();
+            if (all)
+                _cond_con.notify_all();
+            else
+                _cond_con.notify_one();
+        }
+
+        static void backoff(unsigned spin)
+        {
+            if (spin < 64)
+                return;
+            if (spin < 1024)
+                std::this_thread::yield();
+            else
+                std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+
+        // 非阻塞策略：先确认空间足够再用 CAS 预留，预留失败的记录不会占据环中的位置，可以直接丢弃
+        bool tryReserve(uint64_t frame, size_t len, LogLevel::value level, uint64_t &pos)
+        {
+            bool full = false;
+            Clock::time_point deadline;
+            pos = _tail.load(std::memory_order_relaxed);
+            for (unsigned spin = 0;; spin++)
+            {
+                if (pos + frame - __atomic_load_n(&_head, __ATOMIC_ACQUIRE) <= _cap)
+                {
+                    if (_tail.compare_exchange_weak(pos, pos + frame, std::memory_order_relaxed))
+                        return true;
+                    continue; // pos 已被更新为最新的写游标
+                }
+                if (!full)
+                {
+                    full = true;
+                    deadline = overflowDeadline();
+                }
+                if (!keepWaiting(level, deadline) || _exited.load(std::memory_order_acquire))
+                {
+                    countDrop(1, len);
+                    return false;
+                }
+                backoff(spin);
+                pos = _tail.load(std::memory_order_relaxed);
+            }
+        }
+
+        bool committed(uint64_t pos) { return __atomic_load_n(headerAt(pos), __ATOMIC_ACQUIRE) != 0; }
+
+        // 与生产者的"提交记录头 -> fence -> 读 _sleeping"配对：声明之后再读记录头，两边至少有一方看到对方
+        void announceSleep()
+        {
+            _sleeping.store(true, std::memory_order_seq_cst);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+        }
+
+        // 把从读游标开始的连续已提交记录搬到消费缓冲区，返回搬走的条数
+        size_t drain()
+        {
+            size_t count = 0;
+            uint64_t head = _head;
+            while (1)
+            {
+                uint64_t h = __atomic_load_n(headerAt(head), __ATOMIC_ACQUIRE);
+                if (h == 0)
+                    break;
+                size_t len = static_cast<size_t>(h >> 1);
+                if (_con_buf.readableSize() + len > _cap)
+                    break; // 消费缓冲区已满，先交给回调
+                uint64_t frame = frameSize(len);
+                copyOut(head + HEADER_SIZE, len);
+                zero(head, frame);
+                head += frame;
+                __atomic_store_n(&_head, head, __ATOMIC_RELEASE); // 及时归还空间给等待中的生产者
+                count++;
+            }
+            return count;
+        }
+
+        void threadEntry()
+        {
+            while (1)
+            {
+                if (drain() > 0)
+                {
+                    if (_callBack)
+                        _callBack(_con_buf);
+                    _con_buf.reset();
+                    armTick();
+                    continue;
+                }
+                // 停止后，把已经预留的记录（可能尚未提交）全部处理完才退出
+                if (!_running && _head == _tail.load(std::memory_order_seq_cst))
+                    break;
+                if (tickArmed() && Clock::now() >= tickDue())
+                {
+                    fireTick(_callBack, _con_buf);
+                    continue;
+                }
+
+                // 先声明要睡，再复查一次，避免与生产者的提交错过
+                announceSleep();
+                if (!committed(_head) && _running)
+                {
+                    auto until = Clock::now() + std::chrono::milliseconds(100);
+                    if (tickArmed())
+                        until = std::min(until, tickDue());
+                    std::unique_lock<std::mutex> lock(_mutex);
+                    while (!committed(_head) && _running)
+                    {
+                        if (_cond_con.wait_until(lock, until) == std::cv_status::timeout)
+                            break;
+                        // 唤醒我们的可能是 _head 之后的某条记录的生产者，它已经清掉了 _sleeping；
+                        // 重新声明再睡，否则 _head 处的生产者提交时看不到、不会再唤醒
+                        announceSleep();
+                    }
+                }
+                _sleeping.store(false, std::memory_order_relaxed);
+                if (!_running && !committed(_head) && _head != _tail.load(std::memory_order_acquire))
+                    std::this_thread::yield(); // 等待已预留的生产者完成提交
+            }
+            _exited.store(true, std::memory_order_release);
+        }
+
+    private:
+        Functor _callBack;
+        const size_t _cap;
+        std::vector<uint64_t> _ring; // 以 8 字节为单位分配，保证记录头对齐
+        Buffer _con_buf;             // 消费缓冲区：回调看到的仍是连续的 Buffer
+
+        alignas(64) std::atomic<uint64_t> _tail{0}; // 写游标（生产者共享）
+        alignas(64) uint64_t _head = 0;             // 读游标（仅消费者写，生产者原子读）
+        alignas(64) std::atomic<bool> _sleeping{false};
+        std::atomic<bool> _exited{false};
+
+        std::atomic<bool> _running;
+        std::mutex _mutex;
+        std::condition_variable _cond_con;
+        std::thread _thread;
+    };
+}
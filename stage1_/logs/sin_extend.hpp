@@ -65,6 +65,17 @@ namespace mylog
             assert(_ofs.good());
         }
 
+        // 一批记录几乎同时到达，只判断一次是否跨时间段，整批一次写入
+        void logBatch(const char *data, size_t len, const SinkRecord *, size_t) override
+        {
+            log(data, len);
+        }
+
+        void flush() override
+        {
+            _ofs.flush();
+        }
+
     private:
         void rotate(time_t now)
         {
@@ -6,12 +6,25 @@
 #pragma once
 
 #include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
 #include <memory>
 #include <iostream>
 #include <sstream>
 #include <fstream>
 #include <cassert>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
 #include <string>
+#include <thread>
 
 #include "format.hpp"
 #include "util.hpp"
@@ -20,6 +33,14 @@
 
 namespace mylog
 {
+    // 批量落地中一条记录的描述：长度、等级与所属日志器 id（Logger::id()）
+    struct SinkRecord
+    {
+        size_t len;
+        LogLevel::value level;
+        uint32_t logger;
+    };
+
     class LogSink
     {
     public:
@@ -27,6 +48,20 @@ namespace mylog
         LogSink() {}
         virtual ~LogSink() {}
         virtual void log(const char *data, size_t len) = 0;
+        // 批量落地：data/len 是若干条日志首尾相接的文本，records[i] 描述第 i 条（长度总和等于 len）
+        // 默认逐条转交 log()，需要记录边界的落地无需改动；文件类落地应重写为一次大块写入，
+        // 需要按等级过滤/分流的落地可以直接读 records[i].level，不必再解析文本
+        virtual void logBatch(const char *data, size_t len, const SinkRecord *records, size_t count)
+        {
+            (void)len;
+            for (size_t i = 0; i < count; i++)
+            {
+                log(data, records[i].len);
+                data += records[i].len;
+            }
+        }
+        // 把已写入但仍留在用户态缓冲中的数据交给系统（Logger::flush()/flushOn() 调用），默认无缓冲可刷
+        virtual void flush() {}
     };
 
     // 落地方向：标准输出
@@ -37,42 +72,701 @@ namespace mylog
         {
             std::cout.write(data, len);
         }
+        virtual void logBatch(const char *data, size_t len, const SinkRecord *, size_t) override
+        {
+            std::cout.write(data, len);
+        }
+        virtual void flush() override
+        {
+            std::cout.flush();
+        }
+    };
+    // 文件落地的写入方式
+    enum class FileMode
+    {
+        BUFFERED, // 经过页缓存（默认）
+        DIRECT,   // O_DIRECT 绕过页缓存，见 DirectFile
+        MMAP      // 预分配整份文件并映射写入，见 MmapFile；需要知道文件大小，仅 RollBySizeSink 支持
+    };
+
+    inline constexpr size_t DEFAULT_DIRECT_BUFFER_SIZE = 1024 * 1024;
+
+    // O_DIRECT 文件写入（FileSink/RollBySizeSink 的 FileMode::DIRECT 使用）
+    //   1.数据先拷进按 4KB 对齐的暂存缓冲，写满后整块 pwrite 到按 4KB 对齐的偏移，不占页缓存
+    //   2.flush()/close() 时末尾不满一块：补零到 4KB 写出，再 ftruncate 回实际长度；
+    //     未写满的尾块留在缓冲里，下次写出时整块重写，文件里不会残留填充的零
+    //   3.打开已有文件时把不满一块的尾部读回缓冲，接着往后写；只能由本对象追加写入（不使用 O_APPEND）
+    //   4.文件系统不支持 O_DIRECT（如 tmpfs 打开返回 EINVAL，或写入时才报 EINVAL）时退化为普通写入，directIO() 可查询
+    class DirectFile
+    {
+    public:
+        static constexpr size_t ALIGN = 4096;
+
+        // buffer_size 向上取整到 ALIGN 的整数倍
+        explicit DirectFile(size_t buffer_size = DEFAULT_DIRECT_BUFFER_SIZE)
+            : _cap(roundUp(buffer_size ? buffer_size : DEFAULT_DIRECT_BUFFER_SIZE))
+        {
+            void *p = nullptr;
+            if (posix_memalign(&p, ALIGN, _cap) != 0)
+                p = nullptr;
+            _buf = static_cast<char *>(p);
+        }
+        DirectFile(const DirectFile &) = delete;
+        DirectFile &operator=(const DirectFile &) = delete;
+        ~DirectFile()
+        {
+            close();
+            std::free(_buf);
+        }
+
+        // 打开（不存在则创建）文件，成功返回 0，失败返回 errno
+        int open(const std::string &pathname)
+        {
+            close();
+            if (_buf == nullptr)
+                return fail(ENOMEM);
+            _direct = false;
+#ifdef O_DIRECT
+            _fd = ::open(pathname.c_str(), O_RDWR | O_CREAT | O_CLOEXEC | O_DIRECT, 0644);
+            _direct = _fd >= 0;
+            if (_fd < 0 && errno != EINVAL)
+                return fail(errno);
+#endif
+            if (_fd < 0)
+                _fd = ::open(pathname.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+            if (_fd < 0)
+                return fail(errno);
+            struct stat st{};
+            if (::fstat(_fd, &st) != 0)
+                return fail(errno);
+            const uint64_t size = static_cast<uint64_t>(st.st_size);
+            _base = size & ~uint64_t(ALIGN - 1);
+            _used = 0;
+            if (size > _base)
+            {
+                // 读回不满一块的尾部，之后整块重写
+                ssize_t n;
+                do
+                    n = ::pread(_fd, _buf, ALIGN, static_cast<off_t>(_base));
+                while (n < 0 && errno == EINTR);
+                if (n < 0)
+                    return fail(errno);
+                _used = static_cast<size_t>(n);
+            }
+            return 0;
+        }
+        // 写出剩余数据并关闭
+        void close()
+        {
+            if (_fd < 0)
+                return;
+            flush();
+            ::close(_fd);
+            _fd = -1;
+        }
+
+        // 写入 len 字节，成功返回 0，失败返回 errno
+        int append(const char *data, size_t len)
+        {
+            if (_fd < 0)
+                return len ? fail(EBADF) : 0;
+            int err = 0;
+            while (len > 0)
+            {
+                size_t n = std::min(len, _cap - _used);
+                std::memcpy(_buf + _used, data, n);
+                _used += n;
+                data += n;
+                len -= n;
+                if (_used == _cap)
+                {
+                    int e = writeAt(_cap, _base);
+                    err = err ? err : e;
+                    _base += _cap; // 失败也往后走，不让一块坏数据卡住后续写入
+                    _used = 0;
+                }
+            }
+            return err;
+        }
+        // 把缓冲里的数据写到文件：尾块补零写出后截回实际长度，成功返回 0，失败返回 errno
+        int flush()
+        {
+            if (_fd < 0 || _used == 0)
+                return 0;
+            const size_t padded = roundUp(_used);
+            std::memset(_buf + _used, 0, padded - _used);
+            int err = writeAt(padded, _base);
+            if (err == 0 && padded != _used && ::ftruncate(_fd, static_cast<off_t>(_base + _used)) != 0)
+                err = fail(errno);
+            // 写满的块不再需要，不满的尾块挪到缓冲开头
+            const size_t full = _used & ~(ALIGN - 1);
+            if (full > 0)
+            {
+                std::memmove(_buf, _buf + full, _used - full);
+                _base += full;
+                _used -= full;
+            }
+            return err;
+        }
+
+        bool isOpen() const { return _fd >= 0; }
+        // 是否真正以 O_DIRECT 写入（文件系统不支持时为 false）
+        bool directIO() const { return _direct; }
+        // 文件的实际长度（含缓冲里尚未写出的部分）
+        uint64_t size() const { return _base + _used; }
+        // 最近一次失败的 errno（0 表示从未失败）与累计失败次数
+        int lastError() const { return _last_error; }
+        size_t errorCount() const { return _errors; }
+
+    private:
+        static size_t roundUp(size_t n) { return (n + ALIGN - 1) & ~(ALIGN - 1); }
+
+        // 把缓冲开头的 len 字节（ALIGN 的整数倍）写到 offset
+        int writeAt(size_t len, uint64_t offset)
+        {
+            size_t done = 0;
+            while (done < len)
+            {
+                ssize_t n = ::pwrite(_fd, _buf + done, len - done, static_cast<off_t>(offset + done));
+                if (n < 0)
+                {
+                    if (errno == EINTR)
+                        continue;
+#ifdef O_DIRECT
+                    if (errno == EINVAL && _direct)
+                    {
+                        // 打开成功但写入时才拒绝（对齐要求大于 4KB 等），去掉 O_DIRECT 重试
+                        int flags = ::fcntl(_fd, F_GETFL);
+                        if (flags >= 0 && ::fcntl(_fd, F_SETFL, flags & ~O_DIRECT) == 0)
+                        {
+                            _direct = false;
+                            continue;
+                        }
+                    }
+#endif
+                    return fail(errno);
+                }
+                done += static_cast<size_t>(n);
+            }
+            return 0;
+        }
+        int fail(int err)
+        {
+            _last_error = err;
+            _errors++;
+            return err;
+        }
+
+        int _fd = -1;
+        bool _direct = false;
+        char *_buf = nullptr; // 按 ALIGN 对齐的暂存缓冲，_buf[0] 对应文件偏移 _base
+        size_t _cap;
+        size_t _used = 0;
+        uint64_t _base = 0;
+        int _last_error = 0;
+        size_t _errors = 0;
+    };
+
+    // 内存映射文件写入（RollBySizeSink 的 FileMode::MMAP 使用）
+    //   1.open() 用 fallocate 把文件预分配到 capacity 并整段 MAP_SHARED 映射，追加只是一次 memcpy，不再有 write 系统调用；
+    //     写到哪里就用 MADV_POPULATE_WRITE 提前缺页一段（PREFAULT_CHUNK），把逐页的缺页中断合成一次系统调用
+    //   2.数据一拷进映射就在页缓存里，进程崩溃也不会丢，由内核照常回写；flush() 只发起 msync(MS_ASYNC)，不等待落盘
+    //   3.close() 时 msync(MS_ASYNC)、ftruncate 回实际写入的长度、munmap；写入期间文件长度是 capacity，尾部是零，
+    //     进程崩溃留下的文件需要去掉末尾的零
+    //   4.单次写入超过剩余空间时扩大预分配并重新映射；映射失败（如 fallocate 报 ENOSPC）时退化为 pwrite
+    // 映射写入滚动时的后台回收：munmap 整段映射、截回实际长度、关闭文件都交给一条后台线程，
+    // 不占用写日志的线程；第一次提交时才启动线程，和 FlushTimer 一样故意不析构
+    class MmapReclaimer
+    {
+    public:
+        struct Job
+        {
+            int fd;
+            char *map;
+            size_t cap;
+            size_t used;
+        };
+
+        static MmapReclaimer &getInstance()
+        {
+            static MmapReclaimer *reclaimer = new MmapReclaimer();
+            return *reclaimer;
+        }
+
+        // 返回这项任务的序号，waitFor() 用它等待完成
+        uint64_t submit(const Job &job)
+        {
+            std::lock_guard<std::mutex> lk(_mutex);
+            _jobs.push_back(job);
+            if (!_thread.joinable())
+                _thread = std::thread(&MmapReclaimer::threadEntry, this);
+            _cond.notify_one();
+            return ++_submitted;
+        }
+        // 阻塞到序号不大于 ticket 的任务都已完成
+        void waitFor(uint64_t ticket)
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _done_cond.wait(lock, [&]
+                            { return _done >= ticket; });
+        }
+
+        // 同步执行一项回收，MmapFile::close() 也用它；失败返回 errno
+        static int reclaim(const Job &job)
+        {
+            int err = 0;
+            if (job.map != nullptr)
+            {
+                if (job.used > 0 && ::msync(job.map, job.used, MS_ASYNC) != 0)
+                    err = errno;
+                ::munmap(job.map, job.cap);
+            }
+            if (::ftruncate(job.fd, static_cast<off_t>(job.used)) != 0)
+                err = errno;
+            ::close(job.fd);
+            return err;
+        }
+
+    private:
+        MmapReclaimer() = default;
+        MmapReclaimer(const MmapReclaimer &) = delete;
+        MmapReclaimer &operator=(const MmapReclaimer &) = delete;
+
+        void threadEntry()
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            while (1)
+            {
+                _cond.wait(lock, [&]
+                           { return !_jobs.empty(); });
+                Job job = _jobs.front();
+                _jobs.pop_front();
+                lock.unlock();
+                int err = reclaim(job);
+                if (err != 0)
+                    std::cerr << "MmapReclaimer: " << std::strerror(err) << "\n";
+                lock.lock();
+                _done++;
+                _done_cond.notify_all();
+            }
+        }
+
+        std::mutex _mutex;
+        std::condition_variable _cond;      // 有新任务
+        std::condition_variable _done_cond; // 有任务完成
+        std::deque<Job> _jobs;
+        uint64_t _submitted = 0;
+        uint64_t _done = 0; // 按提交顺序逐项完成
+        std::thread _thread;
+    };
+
+    class MmapFile
+    {
+    public:
+        static constexpr size_t PREFAULT_CHUNK = 2 * 1024 * 1024;
+
+        MmapFile() = default;
+        MmapFile(const MmapFile &) = delete;
+        MmapFile &operator=(const MmapFile &) = delete;
+        ~MmapFile()
+        {
+            close();
+            // 之前滚动交出去的文件也要截回实际长度后才算写完
+            if (_ticket)
+                MmapReclaimer::getInstance().waitFor(_ticket);
+        }
+
+        // 打开（不存在则创建）文件并映射 capacity 字节，已有内容保留、接着往后写；成功返回 0，失败返回 errno
+        int open(const std::string &pathname, size_t capacity)
+        {
+            close();
+            _fd = ::open(pathname.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+            if (_fd < 0)
+                return fail(errno);
+            struct stat st{};
+            if (::fstat(_fd, &st) != 0)
+                return fail(errno);
+            _used = static_cast<size_t>(st.st_size);
+            mapTo(std::max(capacity, _used + 1)); // 映射不了时退化为 pwrite，错误记在 lastError() 里
+            return 0;
+        }
+        // 截回实际长度并关闭
+        void close()
+        {
+            if (_fd < 0)
+                return;
+            int err = MmapReclaimer::reclaim(detach());
+            if (err != 0)
+                fail(err);
+        }
+        // 同 close()，但 munmap/ftruncate/close 交给后台回收线程，调用方马上可以打开下一份文件（滚动时使用）
+        void closeAsync()
+        {
+            if (_fd < 0)
+                return;
+            _ticket = MmapReclaimer::getInstance().submit(detach());
+        }
+
+        // 写入 len 字节，成功返回 0，失败返回 errno
+        int append(const char *data, size_t len)
+        {
+            if (_fd < 0)
+                return len ? fail(EBADF) : 0;
+            if (len == 0)
+                return 0;
+            if (_map != nullptr && len > _cap - _used)
+                mapTo(std::max(_used + len, _cap * 2));
+            if (_map == nullptr)
+                return pwriteAll(data, len);
+            if (_used + len > _prefaulted)
+                prefault(_used + len);
+            std::memcpy(_map + _used, data, len);
+            _used += len;
+            return 0;
+        }
+        // 数据已在页缓存里，只提醒内核回写，不等待
+        int flush()
+        {
+            if (_map == nullptr || _used == 0)
+                return 0;
+            if (::msync(_map, _used, MS_ASYNC) != 0)
+                return fail(errno);
+            return 0;
+        }
+
+        bool isOpen() const { return _fd >= 0; }
+        // 是否通过映射写入（映射失败退化为 pwrite 时为 false）
+        bool mapped() const { return _map != nullptr; }
+        // 已写入的字节数
+        size_t size() const { return _used; }
+        // 最近一次失败的 errno（0 表示从未失败）与累计失败次数
+        int lastError() const { return _last_error; }
+        size_t errorCount() const { return _errors; }
+
+    private:
+        static size_t roundUp(size_t n)
+        {
+            const size_t page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+            return (n + page - 1) / page * page;
+        }
+
+        // 交出文件与映射，本对象回到未打开状态
+        MmapReclaimer::Job detach()
+        {
+            MmapReclaimer::Job job{_fd, _map, _cap, _used};
+            _fd = -1;
+            _map = nullptr;
+            _cap = 0;
+            _used = 0;
+            return job;
+        }
+
+        // 预分配到 capacity 并重新映射；失败时不留映射，返回 errno
+        int mapTo(size_t capacity)
+        {
+            unmap();
+            capacity = roundUp(capacity);
+            // 先真正分配磁盘块：只 ftruncate 出空洞的话，磁盘写满时写映射会收到 SIGBUS
+            if (::fallocate(_fd, 0, 0, static_cast<off_t>(capacity)) != 0)
+            {
+                int err = errno;
+                if (err != EOPNOTSUPP && err != ENOSYS)
+                    return fail(err);
+                if (::ftruncate(_fd, static_cast<off_t>(capacity)) != 0)
+                    return fail(errno);
+            }
+            void *p = ::mmap(nullptr, capacity, PROT_READ | PROT_WRITE, MAP_SHARED, _fd, 0);
+            if (p == MAP_FAILED)
+            {
+                int err = fail(errno);
+                if (::ftruncate(_fd, static_cast<off_t>(_used)) != 0)
+                    fail(errno);
+                return err;
+            }
+            _map = static_cast<char *>(p);
+            _cap = capacity;
+            _prefaulted = _used;
+            return 0;
+        }
+        void unmap()
+        {
+            if (_map == nullptr)
+                return;
+            if (_used > 0 && ::msync(_map, _used, MS_ASYNC) != 0)
+                fail(errno);
+            ::munmap(_map, _cap);
+            _map = nullptr;
+            _cap = 0;
+        }
+        // 把 [_prefaulted, end + PREFAULT_CHUNK) 一次性缺页（内核不支持时照常逐页缺页）
+        void prefault(size_t end)
+        {
+#ifdef MADV_POPULATE_WRITE
+            const size_t page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+            size_t from = _prefaulted / page * page;
+            size_t to = std::min(_cap, roundUp(end + PREFAULT_CHUNK));
+            if (to > from)
+                ::madvise(_map + from, to - from, MADV_POPULATE_WRITE);
+            _prefaulted = to;
+#else
+            _prefaulted = _cap;
+            (void)end;
+#endif
+        }
+        int pwriteAll(const char *data, size_t len)
+        {
+            while (len > 0)
+            {
+                ssize_t n = ::pwrite(_fd, data, len, static_cast<off_t>(_used));
+                if (n < 0)
+                {
+                    if (errno == EINTR)
+                        continue;
+                    return fail(errno);
+                }
+                data += n;
+                len -= static_cast<size_t>(n);
+                _used += static_cast<size_t>(n);
+            }
+            return 0;
+        }
+        int fail(int err)
+        {
+            _last_error = err;
+            _errors++;
+            return err;
+        }
+
+        int _fd = -1;
+        char *_map = nullptr; // 映射起点，对应文件偏移 0
+        size_t _cap = 0;        // 映射（预分配）的长度
+        size_t _used = 0;       // 已写入的长度
+        size_t _prefaulted = 0; // [0, _prefaulted) 已提前缺页
+        int _last_error = 0;
+        size_t _errors = 0;
+        uint64_t _ticket = 0; // 最近一次交给后台回收的序号
     };
+
     // 落地方向：指定文件
     class FileSink : public LogSink
     {
     public:
         // 构造是传入文件名，并打开文件，将操作句柄进行管理
-        FileSink(const std::string &pathname) : _pathname(pathname)
+        // mode 为 FileMode::DIRECT 时以 O_DIRECT 写入，direct_buffer_size 为暂存缓冲大小（见 DirectFile）；
+        // FileMode::MMAP 不适用于没有大小上限的文件，按 BUFFERED 写入
+        FileSink(const std::string &pathname, FileMode mode = FileMode::BUFFERED,
+                 size_t direct_buffer_size = DEFAULT_DIRECT_BUFFER_SIZE)
+            : _pathname(pathname)
         {
             // 1. 创建日志文件所在的目录
             if (!util::File::exists(util::File::path(pathname)))
             {
                 util::File::createDirectory(util::File::path(pathname));
             }
-            // 2.创建并打开日志文件
+            // 2.创建并打开日志文件（MMAP 需要预先知道文件大小，FileSink 没有上限，一律按 BUFFERED 处理）
+            if (mode == FileMode::DIRECT)
+            {
+                _direct.reset(new DirectFile(direct_buffer_size));
+                _direct->open(_pathname);
+                assert(_direct->isOpen());
+                return;
+            }
             _ofs.open(_pathname, std::ios::binary | std::ios::app);
             assert(_ofs.is_open());
         }
         // 将日志消息进行写入
         virtual void log(const char *data, size_t len) override
         {
+            write(data, len);
+        }
+        // 整批一次写入，不再逐条调用 ofstream::write
+        virtual void logBatch(const char *data, size_t len, const SinkRecord *, size_t) override
+        {
+            write(data, len);
+        }
+        virtual void flush() override
+        {
+            if (_direct)
+                _direct->flush();
+            else
+                _ofs.flush();
+        }
+
+        // 是否真正以 O_DIRECT 写入（BUFFERED 模式或文件系统不支持时为 false）
+        bool directIO() const { return _direct && _direct->directIO(); }
+
+    private:
+        void write(const char *data, size_t len)
+        {
+            if (_direct)
+            {
+                int err = _direct->append(data, len);
+                assert(err == 0);
+                (void)err;
+                return;
+            }
             _ofs.write(data, len);
             assert(_ofs.good());
         }
 
-    private:
         std::string _pathname;
         std::ofstream _ofs;
+        std::unique_ptr<DirectFile> _direct; // 仅 FileMode::DIRECT
+    };
+
+    inline constexpr size_t DEFAULT_FD_BUFFER_SIZE = 64 * 1024;
+
+    // 落地方向：指定文件（POSIX 版，可直接替换 FileSink）
+    //   1.open(O_APPEND) 直接持有文件描述符，写入不经过 iostream 的 sentry/locale
+    //   2.自带按页对齐的写缓冲（大小可配，0 表示不缓冲）；放得进缓冲的只做 memcpy，
+    //     放不下时把缓冲里的旧数据和本次数据用一次 writev 写出，大批量文本不再拷贝
+    //   3.写失败不 assert：append()/flushBuffer() 返回 errno，并记在 lastError()/errorCount() 里
+    class FdFileSink : public LogSink
+    {
+    public:
+        FdFileSink(const std::string &pathname, size_t buffer_size = DEFAULT_FD_BUFFER_SIZE)
+            : _pathname(pathname), _cap(buffer_size)
+        {
+            const std::string parent = util::File::path(pathname);
+            try
+            {
+                if (!parent.empty() && !util::File::exists(parent))
+                    util::File::createDirectory(parent);
+            }
+            catch (const std::exception &)
+            {
+                // 目录建不出来时 open 会失败，错误码记在 lastError() 里
+            }
+            _fd = ::open(_pathname.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+            if (_fd < 0)
+                _open_error = fail(errno);
+            if (_cap > 0)
+            {
+                void *p = nullptr;
+                if (posix_memalign(&p, BUFFER_ALIGN, _cap) != 0)
+                    _cap = 0; // 分配失败就退化为不缓冲
+                _buf = static_cast<char *>(p);
+            }
+        }
+        FdFileSink(const FdFileSink &) = delete;
+        FdFileSink &operator=(const FdFileSink &) = delete;
+        ~FdFileSink()
+        {
+            flushBuffer();
+            if (_fd >= 0)
+                ::close(_fd);
+            std::free(_buf);
+        }
+
+        virtual void log(const char *data, size_t len) override
+        {
+            append(data, len);
+        }
+        // 整批文本本来就是连续的，与 log() 一样处理
+        virtual void logBatch(const char *data, size_t len, const SinkRecord *, size_t) override
+        {
+            append(data, len);
+        }
+        virtual void flush() override
+        {
+            flushBuffer();
+        }
+
+        // 写入 len 字节，成功返回 0，失败返回 errno（失败时缓冲里的数据一并丢弃）
+        int append(const char *data, size_t len)
+        {
+            if (len == 0)
+                return 0;
+            if (len <= _cap - _used)
+            {
+                std::memcpy(_buf + _used, data, len);
+                _used += len;
+                return 0;
+            }
+            struct iovec iov[2] = {{_buf, _used}, {const_cast<char *>(data), len}};
+            int err = _used ? writeAll(iov, 2) : writeAll(iov + 1, 1);
+            _used = 0;
+            return err;
+        }
+        // 把缓冲里的数据写到文件，成功返回 0，失败返回 errno
+        int flushBuffer()
+        {
+            if (_used == 0)
+                return 0;
+            struct iovec iov = {_buf, _used};
+            _used = 0;
+            return writeAll(&iov, 1);
+        }
+
+        bool isOpen() const { return _fd >= 0; }
+        size_t bufferSize() const { return _cap; }
+        // 最近一次失败的 errno（0 表示从未失败）与累计失败次数
+        int lastError() const { return _last_error; }
+        size_t errorCount() const { return _errors; }
+
+    private:
+        static constexpr size_t BUFFER_ALIGN = 4096;
+
+        // 写完整个 iovec 数组：处理 EINTR 与部分写入
+        int writeAll(struct iovec *iov, int cnt)
+        {
+            if (_fd < 0)
+                return fail(_open_error); // 打开失败后每次写入都返回当初的错误
+            while (cnt > 0)
+            {
+                ssize_t n = ::writev(_fd, iov, cnt);
+                if (n < 0)
+                {
+                    if (errno == EINTR)
+                        continue;
+                    return fail(errno);
+                }
+                size_t left = static_cast<size_t>(n);
+                while (cnt > 0 && left >= iov->iov_len)
+                {
+                    left -= iov->iov_len;
+                    iov++;
+                    cnt--;
+                }
+                if (cnt > 0)
+                {
+                    iov->iov_base = static_cast<char *>(iov->iov_base) + left;
+                    iov->iov_len -= left;
+                }
+            }
+            return 0;
+        }
+        int fail(int err)
+        {
+            _last_error = err;
+            _errors++;
+            return err;
+        }
+
+        std::string _pathname;
+        int _fd = -1;
+        char *_buf = nullptr; // 按 BUFFER_ALIGN 对齐的写缓冲
+        size_t _cap;
+        size_t _used = 0;
+        int _open_error = 0;
+        int _last_error = 0;
+        size_t _errors = 0;
     };
 
     // 落地方向：滚动文件（以大小进行滚动）
     class RollBySizeSink : public LogSink
     {
     public:
-        RollBySizeSink(const std::string &basename, size_t max_size) : _basename(basename),
-                                                                       _max_size(max_size), _cur_size(0), _seq(0)
+        // mode 为 FileMode::DIRECT 时每份文件都以 O_DIRECT 写入，滚动前尾块补零写出再截回实际长度；
+        // 为 FileMode::MMAP 时每份文件预分配 max_size 并映射写入，滚动时截回实际长度
+        RollBySizeSink(const std::string &basename, size_t max_size, FileMode mode = FileMode::BUFFERED,
+                       size_t direct_buffer_size = DEFAULT_DIRECT_BUFFER_SIZE)
+            : _basename(basename), _max_size(max_size), _cur_size(0), _seq(0)
         {
+            if (mode == FileMode::DIRECT)
+                _direct.reset(new DirectFile(direct_buffer_size));
+            else if (mode == FileMode::MMAP)
+                _mmap.reset(new MmapFile());
             // // 1. 创建日志文件所在的目录
             // std::string pathname = createNewFile();
             // if (!util::File::exists(util::File::path(pathname)))
@@ -98,43 +792,131 @@ namespace mylog
             // _ofs.write(data, len);
             // assert(_ofs.good());
             // _cur_size += len;
-            if (!_ofs.is_open())
-            {
-                const std::string pathname = createNewFile();
-                if (!util::File::exists(util::File::path(pathname)))
-                    util::File::createDirectory(util::File::path(pathname));
-                _ofs.open(pathname, std::ios::binary | std::ios::app);
-                assert(_ofs.is_open());
-                _cur_size = 0; // 首开一定从 0 开始
-            }
+            openIfNeeded();
 
             if (_cur_size + len > _max_size && _cur_size > 0)
             {
                 rotate();
             }
-            _ofs.write(data, len);
-            if (!_ofs.good())
-                std::cerr << "RollBySizeSink write error\n";
-            _cur_size += len;
+            write(data, len);
+            if (_cur_size >= _max_size)
+            {
+                rotate();
+            }
+        }
+
+        // 批量写入：只在记录边界上滚动，同一个文件内的连续记录合并为一次写入
+        virtual void logBatch(const char *data, size_t len, const SinkRecord *records, size_t count) override
+        {
+            (void)len;
+            openIfNeeded();
+
+            size_t chunk = 0; // 已累积、尚未写出的字节数
+            for (size_t i = 0; i < count; i++)
+            {
+                if (_cur_size + chunk + records[i].len > _max_size && _cur_size + chunk > 0)
+                {
+                    write(data, chunk);
+                    data += chunk;
+                    chunk = 0;
+                    rotate();
+                }
+                chunk += records[i].len;
+            }
+            write(data, chunk);
             if (_cur_size >= _max_size)
             {
                 rotate();
             }
         }
 
+        virtual void flush() override
+        {
+            if (_direct)
+                _direct->flush();
+            else if (_mmap)
+                _mmap->flush();
+            else if (_ofs.is_open())
+                _ofs.flush();
+        }
+
+        // 是否真正以 O_DIRECT 写入（BUFFERED 模式或文件系统不支持时为 false）
+        bool directIO() const { return _direct && _direct->directIO(); }
+        // 当前文件是否通过映射写入（非 MMAP 模式、尚未打开或映射失败退化为 pwrite 时为 false）
+        bool mapped() const { return _mmap && _mmap->mapped(); }
+
     private:
+        void openIfNeeded()
+        {
+            if (_direct ? _direct->isOpen() : _mmap ? _mmap->isOpen() : _ofs.is_open())
+                return;
+            const std::string pathname = createNewFile();
+            if (!util::File::exists(util::File::path(pathname)))
+                util::File::createDirectory(util::File::path(pathname));
+            openFile(pathname);
+            _cur_size = 0; // 首开一定从 0 开始
+        }
+
+        void write(const char *data, size_t len)
+        {
+            if (len == 0)
+                return;
+            if (_direct || _mmap)
+            {
+                if ((_direct ? _direct->append(data, len) : _mmap->append(data, len)) != 0)
+                    std::cerr << "RollBySizeSink write error\n";
+            }
+            else
+            {
+                _ofs.write(data, len);
+                if (!_ofs.good())
+                    std::cerr << "RollBySizeSink write error\n";
+            }
+            _cur_size += len;
+        }
+
         void rotate()
         {
-            _ofs.flush();
-            _ofs.close();
+            if (_direct)
+            {
+                _direct->close(); // 尾块补零写出后截回实际长度
+            }
+            else if (_mmap)
+            {
+                _mmap->closeAsync(); // 解除映射、截回实际写入的长度交给后台线程，不在这里等待
+            }
+            else
+            {
+                _ofs.flush();
+                _ofs.close();
+            }
             const std::string pathname = createNewFile();
             if (!util::File::exists(util::File::path(pathname)))
             {
                 util::File::createDirectory(util::File::path(pathname));
             }
+            openFile(pathname);
+            _cur_size = _direct ? static_cast<size_t>(_direct->size())
+                        : _mmap ? _mmap->size()
+                                : static_cast<size_t>(_ofs.tellp());
+        }
+
+        void openFile(const std::string &pathname)
+        {
+            if (_direct)
+            {
+                _direct->open(pathname);
+                assert(_direct->isOpen());
+                return;
+            }
+            if (_mmap)
+            {
+                _mmap->open(pathname, _max_size);
+                assert(_mmap->isOpen());
+                return;
+            }
             _ofs.open(pathname, std::ios::binary | std::ios::app);
             assert(_ofs.is_open());
-            _cur_size = static_cast<size_t>(_ofs.tellp());
         }
 
         std::string createNewFile()
@@ -166,6 +948,8 @@ namespace mylog
         // 在基础文件名上进行追加扩展（文件名 = basename + addname）
         std::string _basename;
         std::ofstream _ofs;
+        std::unique_ptr<DirectFile> _direct; // 仅 FileMode::DIRECT
+        std::unique_ptr<MmapFile> _mmap;     // 仅 FileMode::MMAP
         size_t _max_size;
         size_t _cur_size;
         size_t _seq;
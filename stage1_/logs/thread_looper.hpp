@@ -0,0 +1,474 @@
+/*按线程分队列的异步工作器
+    1.每个生产者线程第一次写某个日志器时，通过 thread_local 懒注册一条自己的单生产者单消费者队列，生产者之间没有任何共享写入
+    2.每条记录带自己的时间戳（日志器通过 stamp() 取得，也就是落地时打印的时间），后台线程对所有队列做 k 路归并，按时间戳顺序交给回调
+    3.生产者取时间戳之前先在自己的队列上登记"有记录在途"；后台只交出不晚于所有队列下界（低水位）的记录，
+      晚到的记录不会排在已经交出的更新记录之后
+    4.线程退出时队列只被标记为关闭，已入队的记录仍由后台线程取完后再回收
+*/
+#pragma once
+
+#include "looper.hpp"
+#include "util.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+namespace mylog
+{
+    inline constexpr size_t DEFAULT_THREAD_QUEUE_SIZE = 1024 * 1024;
+
+    // 单生产者单消费者的字节环：记录在环内保持连续，放不下时写一个回绕标记跳到开头
+    class SpscQueue
+    {
+    public:
+        using ptr = std::shared_ptr<SpscQueue>;
+        struct Entry
+        {
+            uint64_t ts;
+            const char *data;
+            size_t len;
+        };
+
+        // capacity 向上取整到 2 的幂，最小 4KB
+        explicit SpscQueue(size_t capacity)
+            : _cap(roundCapacity(capacity)), _buf(_cap / sizeof(uint64_t), 0) {}
+
+        // 单条记录的上限：保证回绕浪费的空间加上记录本身不超过环大小
+        size_t maxRecord() const { return _cap / 2 - HEADER_SIZE; }
+
+        // 生产者：先登记一条在途记录（下界取本队列上一条的时间戳），再取时钟，
+        // 这样后台在登记之前读到的时钟一定不晚于这条记录的时间戳
+        uint64_t enter()
+        {
+            _inflight.store(std::max<uint64_t>(_last_ts, 1), std::memory_order_seq_cst);
+            uint64_t ts = std::max(_last_ts, util::Date::nowNs());
+            _inflight.store(ts, std::memory_order_seq_cst);
+            return ts;
+        }
+        // 生产者：在途记录已入队（或被丢弃）
+        void leave() { _inflight.store(0, std::memory_order_release); }
+        // 生产者：本条记录的时间戳，没有经过 enter() 的（flush 标记）取当前时刻
+        uint64_t pending() const
+        {
+            uint64_t ts = _inflight.load(std::memory_order_relaxed);
+            return ts ? ts : std::max(_last_ts, util::Date::nowNs());
+        }
+        // 消费者：在途记录时间戳的下界，0 表示没有在途记录
+        uint64_t inflight() const { return _inflight.load(std::memory_order_seq_cst); }
+
+        // 生产者：空间不足返回 false
+        bool tryPush(uint64_t ts, const char *data, size_t len)
+        {
+            const uint64_t frame = frameSize(len);
+            uint64_t t = _tail.load(std::memory_order_relaxed);
+            size_t off = t & (_cap - 1);
+            size_t to_end = _cap - off;
+            uint64_t need = to_end < frame ? to_end + frame : frame;
+            if (t + need - _head.load(std::memory_order_acquire) > _cap)
+                return false;
+            if (to_end < frame)
+            {
+                Header wrap{WRAP, 0, 0};
+                std::memcpy(bytes() + off, &wrap, sizeof(wrap));
+                t += to_end;
+                off = 0;
+            }
+            Header h{static_cast<uint32_t>(len), 0, ts};
+            std::memcpy(bytes() + off, &h, sizeof(h));
+            std::memcpy(bytes() + off + HEADER_SIZE, data, len);
+            _tail.store(t + frame, std::memory_order_release);
+            _last_ts = ts;
+            return true;
+        }
+
+        // 消费者：取队首记录但不出队
+        bool front(Entry &e)
+        {
+            uint64_t h = _head.load(std::memory_order_relaxed);
+            if (h == _tail.load(std::memory_order_acquire))
+                return false;
+            Header hd;
+            std::memcpy(&hd, bytes() + (h & (_cap - 1)), sizeof(hd));
+            if (hd.len == WRAP)
+            {
+                h += _cap - (h & (_cap - 1));
+                _head.store(h, std::memory_order_release);
+                if (h == _tail.load(std::memory_order_acquire))
+                    return false;
+                std::memcpy(&hd, bytes(), sizeof(hd));
+            }
+            e.ts = hd.ts;
+            e.data = bytes() + (h & (_cap - 1)) + HEADER_SIZE;
+            e.len = hd.len;
+            return true;
+        }
+        // 消费者：弹出 front() 返回的记录
+        void pop(const Entry &e)
+        {
+            _head.store(_head.load(std::memory_order_relaxed) + frameSize(e.len), std::memory_order_release);
+        }
+        bool empty() const
+        {
+            return _head.load(std::memory_order_acquire) == _tail.load(std::memory_order_acquire);
+        }
+
+        // 所属线程已退出，不会再有新记录
+        void close() { _closed.store(true, std::memory_order_release); }
+        bool closed() const { return _closed.load(std::memory_order_acquire); }
+        // 所属工作器已停止，线程侧可以丢弃这条队列
+        void orphan() { _orphaned.store(true, std::memory_order_release); }
+        bool orphaned() const { return _orphaned.load(std::memory_order_acquire); }
+
+    private:
+        struct Header
+        {
+            uint32_t len;
+            uint32_t reserved;
+            uint64_t ts;
+        };
+        static constexpr size_t HEADER_SIZE = sizeof(Header);
+        static constexpr uint32_t WRAP = UINT32_MAX;
+
+        static size_t roundCapacity(size_t n)
+        {
+            size_t cap = 4096;
+            while (cap < n)
+                cap <<= 1;
+            return cap;
+        }
+        static uint64_t frameSize(size_t len)
+        {
+            return (HEADER_SIZE + len + HEADER_SIZE - 1) & ~static_cast<uint64_t>(HEADER_SIZE - 1);
+        }
+        char *bytes() { return reinterpret_cast<char *>(_buf.data()); }
+
+        const size_t _cap;
+        std::vector<uint64_t> _buf;
+        alignas(64) std::atomic<uint64_t> _tail{0}; // 仅生产者写
+        alignas(64) std::atomic<uint64_t> _head{0}; // 仅消费者写
+        std::atomic<uint64_t> _inflight{0};         // 生产者正在写的记录的时间戳下界，0 表示没有
+        uint64_t _last_ts = 0;                      // 上一条入队记录的时间戳（仅生产者）
+        std::atomic<bool> _closed{false};
+        std::atomic<bool> _orphaned{false};
+    };
+
+    class ThreadQueueLooper : public Looper
+    {
+    public:
+        using ptr = std::shared_ptr<ThreadQueueLooper>;
+        // queue_size 为每个生产者线程的队列大小
+        ThreadQueueLooper(const Functor &callback, size_t queue_size = DEFAULT_THREAD_QUEUE_SIZE,
+                          const OverflowConfig &overflow = OverflowConfig())
+            : Looper(overflow),
+              _callBack(callback),
+              _id(nextId()),
+              _queue_size(queue_size ? queue_size : DEFAULT_THREAD_QUEUE_SIZE),
+              _con_buf_cap(std::max(ROUND_BYTES, _queue_size)),
+              _con_buf(_con_buf_cap),
+              _running(true),
+              _thread(&ThreadQueueLooper::threadEntry, this) {}
+
+        ~ThreadQueueLooper()
+        {
+            stop();
+        }
+
+        virtual void stop() override
+        {
+            bool expected = true;
+            if (!_running.compare_exchange_strong(expected, false))
+            {
+                return;
+            }
+            wakeConsumer();
+            if (_thread.joinable())
+                _thread.join();
+        }
+
+        virtual uint64_t stamp() override
+        {
+            return localQueue()->enter();
+        }
+
+        virtual void push(const char *data, size_t len, LogLevel::value level) override
+        {
+            SpscQueue *q = localQueue();
+            pushTo(q, data, len, level);
+            q->leave();
+        }
+
+        virtual bool setTickInterval(std::chrono::milliseconds interval) override
+        {
+            _tick_ms.store(interval.count(), std::memory_order_relaxed);
+            return true;
+        }
+
+        // 队列大小在构造时确定
+        virtual void setMaxBufferSize(size_t max_size) override
+        {
+            (void)max_size;
+        }
+
+    private:
+        static constexpr size_t ROUND_BYTES = 4 * 1024 * 1024; // 一轮归并最多交给回调的字节数
+
+        void pushTo(SpscQueue *q, const char *data, size_t len, LogLevel::value level)
+        {
+            if (!_running.load(std::memory_order_relaxed))
+            {
+                countDrop(1, len); // 已经停止，不再接收
+                return;
+            }
+            if (len > q->maxRecord())
+            {
+                countDrop(1, len); // 单条记录超过队列能容纳的上限
+                return;
+            }
+            const uint64_t ts = q->pending();
+            bool full = false;
+            Clock::time_point deadline;
+            for (unsigned spin = 0; !q->tryPush(ts, data, len); spin++)
+            {
+                if (!full)
+                {
+                    full = true;
+                    deadline = overflowDeadline();
+                }
+                // 队列只有本线程在写，DROP_OLDEST 无法从生产者侧丢旧记录，按 DROP_NEWEST 处理
+                if (!keepWaiting(level, deadline) || _exited.load(std::memory_order_acquire))
+                {
+                    countDrop(1, len);
+                    return;
+                }
+                backoff(spin);
+            }
+            std::atomic_thread_fence(std::memory_order_seq_cst); // 与消费者的 _sleeping 以及退出流程配对
+            if (!_running.load(std::memory_order_relaxed))
+            {
+                // 与 stop() 并发：等后台线程要么取走这条（队列随之变空，它是队尾），要么已经退出
+                for (unsigned spin = 0; !q->empty() && !_exited.load(std::memory_order_acquire); spin++)
+                    backoff(spin);
+                if (!q->empty())
+                    countDrop(1, len); // 后台线程已退出，这条留在队列里不会再被取走
+                return;
+            }
+            if (_sleeping.load(std::memory_order_relaxed) && _sleeping.exchange(false)) // 只由第一个看到的生产者去唤醒
+                wakeConsumer();
+        }
+
+        static void backoff(unsigned spin)
+        {
+            if (spin < 64)
+                return;
+            if (spin < 1024)
+                std::this_thread::yield();
+            else
+                std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+
+        static uint64_t nextId()
+        {
+            static std::atomic<uint64_t> id{0};
+            return ++id;
+        }
+
+        // 线程侧持有的队列：线程退出时关闭它们，数据留给后台线程取完
+        struct ThreadQueues
+        {
+            struct Slot
+            {
+                uint64_t looper;
+                SpscQueue::ptr queue;
+            };
+            std::vector<Slot> slots;
+            ~ThreadQueues()
+            {
+                for (auto &s : slots)
+                    s.queue->close();
+            }
+        };
+        static ThreadQueues &threadQueues()
+        {
+            static thread_local ThreadQueues tq;
+            return tq;
+        }
+
+        SpscQueue *localQueue()
+        {
+            ThreadQueues &tq = threadQueues();
+            for (auto &s : tq.slots)
+            {
+                if (s.looper == _id)
+                    return s.queue.get();
+            }
+            // 首次写入：顺便清掉已停止的工作器留下的队列
+            tq.slots.erase(std::remove_if(tq.slots.begin(), tq.slots.end(), [](const ThreadQueues::Slot &s)
+                                          { return s.queue->orphaned(); }),
+                           tq.slots.end());
+            auto q = std::make_shared<SpscQueue>(_queue_size);
+            {
+                std::lock_guard<std::mutex> lk(_mutex);
+                _queues.push_back(q);
+                _version++;
+            }
+            tq.slots.push_back({_id, q});
+            return q.get();
+        }
+
+        void wakeConsumer()
+        {
+            std::lock_guard<std::mutex> lk(_mutex);
+            countWakeup();
+            _cond_con.notify_all();
+        }
+
+        // 重新拿一份队列列表，并回收已关闭且取空的队列
+        void refreshQueues()
+        {
+            bool reap = false;
+            for (auto &q : _snapshot)
+                reap = reap || (q->closed() && q->empty());
+            if (!reap && _snapshot_version == _version.load(std::memory_order_acquire))
+                return;
+            std::lock_guard<std::mutex> lk(_mutex);
+            _queues.erase(std::remove_if(_queues.begin(), _queues.end(), [](const SpscQueue::ptr &q)
+                                         { return q->closed() && q->empty(); }),
+                          _queues.end());
+            _snapshot = _queues;
+            _snapshot_version = _version.load(std::memory_order_relaxed);
+        }
+
+        bool anyReady()
+        {
+            for (auto &q : _snapshot)
+            {
+                if (!q->empty())
+                    return true;
+            }
+            return _snapshot_version != _version.load(std::memory_order_acquire);
+        }
+
+        // k 路归并：每次取时间戳最小的队首，拷进消费缓冲区后立即出队归还空间。
+        // 低水位 limit 是空队列上之后可能出现的最早时间戳：有在途记录取它登记的下界，否则取本轮开始时的时钟
+        // （生产者在这之后才取时间戳）；非空队列的新记录不会早于它的队首。时间戳超过 limit 的留到下一轮，
+        // 这时 _held 为 true。now 必须在 refreshQueues() 之前读取，之后注册的新队列同样不会早于它
+        size_t mergeRound(uint64_t now)
+        {
+            using Item = std::pair<uint64_t, size_t>; // (时间戳, 队列下标)
+            std::priority_queue<Item, std::vector<Item>, std::greater<Item>> heap;
+            SpscQueue::Entry e{0, nullptr, 0};
+            uint64_t limit = UINT64_MAX;
+            // 先读在途下界再看队列：读到 0 时，生产者之前入队的记录一定已经可见
+            auto visit = [&](size_t i)
+            {
+                uint64_t inflight = _snapshot[i]->inflight();
+                if (_snapshot[i]->front(e))
+                    heap.push({e.ts, i});
+                else
+                    limit = std::min(limit, inflight ? inflight : now);
+            };
+            for (size_t i = 0; i < _snapshot.size(); i++)
+                visit(i);
+            size_t count = 0;
+            _held = false;
+            while (!heap.empty())
+            {
+                if (heap.top().first > limit)
+                {
+                    _held = true;
+                    break;
+                }
+                size_t idx = heap.top().second;
+                SpscQueue *q = _snapshot[idx].get();
+                heap.pop();
+                q->front(e);
+                if (_con_buf.readableSize() + e.len > _con_buf_cap)
+                    break; // 本轮已满，剩下的下一轮再取
+                _con_buf.push(e.data, e.len);
+                q->pop(e);
+                count++;
+                visit(idx);
+            }
+            return count;
+        }
+
+        void threadEntry()
+        {
+            while (1)
+            {
+                // 先读停止标志再取记录：生产者入队后才看停止标志，两边至少有一方看到对方
+                bool stopping = !_running.load(std::memory_order_seq_cst);
+                uint64_t now = util::Date::nowNs();
+                refreshQueues();
+                if (mergeRound(now) > 0)
+                {
+                    if (_callBack)
+                        _callBack(_con_buf);
+                    _con_buf.reset();
+                    armTick();
+                    continue;
+                }
+                // 有记录在等在途的更早记录入队：生产者很快就会写完，让出 CPU 后再试
+                if (_held)
+                {
+                    std::this_thread::yield();
+                    continue;
+                }
+                // 停止后，所有队列都已取空才退出
+                if (stopping)
+                    break;
+                if (tickArmed() && Clock::now() >= tickDue())
+                {
+                    fireTick(_callBack, _con_buf);
+                    continue;
+                }
+
+                _sleeping.store(true, std::memory_order_seq_cst);
+                if (!anyReady() && _running)
+                {
+                    auto until = Clock::now() + std::chrono::milliseconds(100);
+                    if (tickArmed())
+                        until = std::min(until, tickDue());
+                    std::unique_lock<std::mutex> lock(_mutex);
+                    _cond_con.wait_until(lock, until, [&]
+                                         { return !_running || anyReady(); });
+                }
+                _sleeping.store(false, std::memory_order_relaxed);
+            }
+            _exited.store(true, std::memory_order_release);
+            std::lock_guard<std::mutex> lk(_mutex);
+            for (auto &q : _queues)
+                q->orphan();
+        }
+
+    private:
+        Functor _callBack;
+        const uint64_t _id; // 区分不同工作器在线程侧的队列
+        const size_t _queue_size;
+        const size_t _con_buf_cap;
+        Buffer _con_buf;
+
+        std::vector<SpscQueue::ptr> _queues;   // 全部已注册队列，受 _mutex 保护
+        std::atomic<uint64_t> _version{0};     // 注册新队列时递增
+        std::vector<SpscQueue::ptr> _snapshot; // 后台线程使用的副本
+        uint64_t _snapshot_version = 0;
+
+        bool _held = false; // 上一轮因低水位留下了记录（仅后台线程）
+
+        alignas(64) std::atomic<bool> _sleeping{false};
+        std::atomic<bool> _exited{false};
+        std::atomic<bool> _running;
+        std::mutex _mutex;
+        std::condition_variable _cond_con;
+        std::thread _thread;
+    };
+}
@@ -0,0 +1,374 @@
+/*io_uring 文件落地（Linux）
+    1.直接用 io_uring_setup/io_uring_enter 系统调用，不依赖 liburing；内核或头文件不支持时退化为同步 pwrite
+    2.持有 depth 块写缓冲轮流使用：写满一块就提交给内核，后台线程继续往下一块里拷贝，
+      前几块的写入在内核里完成，不再阻塞在 write(2) 上；所有缓冲都在途时才等待最早的完成
+    3.每块按显式偏移写入，在途写入的完成顺序不影响文件内容；因此文件只能由本落地追加（不使用 O_APPEND）
+    4.写失败不 assert：错误码记在 lastError()/errorCount() 里，短写用同步 pwrite 补齐
+    5.flush() 提交当前缓冲并等待全部在途写入完成，返回时数据已交给内核（页缓存）
+*/
+#pragma once
+
+#include "sink.hpp"
+#include "util.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// 编译时 -DMYLOG_HAVE_IO_URING=0 可强制使用同步 pwrite
+#ifndef MYLOG_HAVE_IO_URING
+#if defined(__linux__) && __has_include(<linux/io_uring.h>) && defined(__NR_io_uring_setup)
+#define MYLOG_HAVE_IO_URING 1
+#else
+#define MYLOG_HAVE_IO_URING 0
+#endif
+#endif
+#if MYLOG_HAVE_IO_URING
+#include <linux/io_uring.h>
+#endif
+
+namespace mylog
+{
+    inline constexpr size_t DEFAULT_URING_BUFFER_SIZE = 1024 * 1024;
+    inline constexpr size_t DEFAULT_URING_DEPTH = 4;
+
+    class UringFileSink : public LogSink
+    {
+    public:
+        // buffer_size 为单块写缓冲大小，depth 为缓冲块数（也就是最多同时在途的写入数，至少 2）
+        UringFileSink(const std::string &pathname, size_t buffer_size = DEFAULT_URING_BUFFER_SIZE,
+                      size_t depth = DEFAULT_URING_DEPTH)
+            : _pathname(pathname), _cap(buffer_size ? buffer_size : DEFAULT_URING_BUFFER_SIZE),
+              _slots(depth < 2 ? 2 : depth)
+        {
+            const std::string parent = util::File::path(pathname);
+            try
+            {
+                if (!parent.empty() && !util::File::exists(parent))
+                    util::File::createDirectory(parent);
+            }
+            catch (const std::exception &)
+            {
+                // 目录建不出来时 open 会失败，错误码记在 lastError() 里
+            }
+            _fd = ::open(_pathname.c_str(), O_WRONLY | O_CREAT | O_CLOEXEC, 0644);
+            if (_fd < 0)
+            {
+                _open_error = fail(errno);
+                return;
+            }
+            off_t end = ::lseek(_fd, 0, SEEK_END);
+            _offset = end > 0 ? static_cast<uint64_t>(end) : 0;
+            for (auto &slot : _slots)
+            {
+                void *p = nullptr;
+                if (posix_memalign(&p, BUFFER_ALIGN, _cap) != 0)
+                {
+                    _open_error = fail(ENOMEM);
+                    return;
+                }
+                slot.buf = static_cast<char *>(p);
+            }
+            setupRing();
+        }
+        UringFileSink(const UringFileSink &) = delete;
+        UringFileSink &operator=(const UringFileSink &) = delete;
+        ~UringFileSink()
+        {
+            flush();
+            teardownRing();
+            if (_fd >= 0)
+                ::close(_fd);
+            for (auto &slot : _slots)
+                std::free(slot.buf);
+        }
+
+        virtual void log(const char *data, size_t len) override
+        {
+            append(data, len);
+        }
+        virtual void logBatch(const char *data, size_t len, const SinkRecord *, size_t) override
+        {
+            append(data, len);
+        }
+        // 提交当前缓冲并等全部在途写入完成
+        virtual void flush() override
+        {
+            if (!ready())
+                return;
+            submitCurrent();
+            while (_inflight > 0)
+                waitOne();
+        }
+
+        // 拷进写缓冲，写满一块就提交；成功返回 0，失败返回 errno（打开失败时每次都返回当初的错误）
+        int append(const char *data, size_t len)
+        {
+            if (!ready())
+                return len ? fail(_open_error) : 0;
+            size_t before = _errors;
+            while (len > 0)
+            {
+                Slot &cur = _slots[_cur];
+                size_t n = std::min(len, _cap - cur.used);
+                std::memcpy(cur.buf + cur.used, data, n);
+                cur.used += n;
+                data += n;
+                len -= n;
+                if (cur.used == _cap)
+                    submitCurrent();
+            }
+            return _errors == before ? 0 : _last_error;
+        }
+
+        bool isOpen() const { return _fd >= 0; }
+        // 是否真正在用 io_uring（false 表示已退化为同步 pwrite）
+        bool usingUring() const { return _ring_fd >= 0; }
+        int lastError() const { return _last_error; }
+        size_t errorCount() const { return _errors; }
+
+    private:
+        static constexpr size_t BUFFER_ALIGN = 4096;
+
+        struct Slot
+        {
+            char *buf = nullptr;
+            size_t used = 0;      // 已写入的字节数
+            bool inflight = false; // 已提交、尚未完成
+            uint64_t offset = 0;  // 提交时分配的文件偏移
+            struct iovec iov{};   // 在途期间内核会读取它，必须一直有效
+        };
+
+        bool ready() const { return _fd >= 0 && _open_error == 0; }
+
+        int fail(int err)
+        {
+            _last_error = err;
+            _errors++;
+            return err;
+        }
+
+        // 同步写满 [buf, buf+len) 到 offset 处（退化路径与短写补齐）
+        void pwriteAll(const char *buf, size_t len, uint64_t offset)
+        {
+            while (len > 0)
+            {
+                ssize_t n = ::pwrite(_fd, buf, len, static_cast<off_t>(offset));
+                if (n < 0)
+                {
+                    if (errno == EINTR)
+                        continue;
+                    fail(errno);
+                    return;
+                }
+                buf += n;
+                len -= static_cast<size_t>(n);
+                offset += static_cast<uint64_t>(n);
+            }
+        }
+
+        // 把当前缓冲交出去并换到下一块（下一块还在途就先等它完成）
+        void submitCurrent()
+        {
+            Slot &cur = _slots[_cur];
+            if (cur.used == 0)
+                return;
+            cur.offset = _offset;
+            _offset += cur.used;
+            if (!submit(_cur))
+            {
+                pwriteAll(cur.buf, cur.used, cur.offset);
+                cur.used = 0;
+            }
+            _cur = (_cur + 1) % _slots.size();
+            while (_slots[_cur].inflight)
+                waitOne();
+        }
+
+#if MYLOG_HAVE_IO_URING
+        void setupRing()
+        {
+            struct io_uring_params p;
+            std::memset(&p, 0, sizeof(p));
+            int fd = static_cast<int>(::syscall(__NR_io_uring_setup, static_cast<unsigned>(_slots.size()), &p));
+            if (fd < 0)
+                return; // ENOSYS/EPERM 等：退化为同步写
+            size_t sq_size = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+            size_t cq_size = p.cq_off.cqes + p.cq_entries * sizeof(struct io_uring_cqe);
+            bool single = p.features & IORING_FEAT_SINGLE_MMAP;
+            if (single)
+                sq_size = cq_size = std::max(sq_size, cq_size);
+            void *sq = ::mmap(nullptr, sq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+            void *cq = single ? sq : ::mmap(nullptr, cq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+            size_t sqes_size = p.sq_entries * sizeof(struct io_uring_sqe);
+            void *sqes = ::mmap(nullptr, sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+            if (sq == MAP_FAILED || cq == MAP_FAILED || sqes == MAP_FAILED)
+            {
+                if (sq != MAP_FAILED)
+                    ::munmap(sq, sq_size);
+                if (!single && cq != MAP_FAILED)
+                    ::munmap(cq, cq_size);
+                if (sqes != MAP_FAILED)
+                    ::munmap(sqes, sqes_size);
+                ::close(fd);
+                return;
+            }
+            char *sqc = static_cast<char *>(sq), *cqc = static_cast<char *>(cq);
+            _sq_ring = sq;
+            _sq_size = sq_size;
+            _cq_ring = single ? nullptr : cq;
+            _cq_size = cq_size;
+            _sqes = static_cast<struct io_uring_sqe *>(sqes);
+            _sqes_size = sqes_size;
+            _sq_tail = reinterpret_cast<unsigned *>(sqc + p.sq_off.tail);
+            _sq_mask = *reinterpret_cast<unsigned *>(sqc + p.sq_off.ring_mask);
+            _sq_array = reinterpret_cast<unsigned *>(sqc + p.sq_off.array);
+            _cq_head = reinterpret_cast<unsigned *>(cqc + p.cq_off.head);
+            _cq_tail = reinterpret_cast<unsigned *>(cqc + p.cq_off.tail);
+            _cq_mask = *reinterpret_cast<unsigned *>(cqc + p.cq_off.ring_mask);
+            _cqes = reinterpret_cast<struct io_uring_cqe *>(cqc + p.cq_off.cqes);
+            _ring_fd = fd;
+        }
+
+        void teardownRing()
+        {
+            if (_ring_fd < 0)
+                return;
+            ::munmap(_sqes, _sqes_size);
+            if (_cq_ring)
+                ::munmap(_cq_ring, _cq_size);
+            ::munmap(_sq_ring, _sq_size);
+            ::close(_ring_fd);
+            _ring_fd = -1;
+        }
+
+        // 提交一块缓冲的写入；ring 不可用或提交失败返回 false，由调用方同步写
+        bool submit(size_t idx)
+        {
+            if (_ring_fd < 0)
+                return false;
+            Slot &slot = _slots[idx];
+            slot.iov.iov_base = slot.buf;
+            slot.iov.iov_len = slot.used;
+            // 单生产者：只有本线程写 SQ 尾指针
+            unsigned tail = *_sq_tail;
+            unsigned i = tail & _sq_mask;
+            struct io_uring_sqe *sqe = &_sqes[i];
+            std::memset(sqe, 0, sizeof(*sqe));
+            sqe->opcode = IORING_OP_WRITEV; // 5.1 起可用，比 IORING_OP_WRITE 兼容的内核更多
+            sqe->fd = _fd;
+            sqe->addr = reinterpret_cast<uint64_t>(&slot.iov);
+            sqe->len = 1;
+            sqe->off = slot.offset;
+            sqe->user_data = idx;
+            _sq_array[i] = i;
+            __atomic_store_n(_sq_tail, tail + 1, __ATOMIC_RELEASE);
+            while (::syscall(__NR_io_uring_enter, _ring_fd, 1u, 0u, 0u, nullptr, 0) < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+                if ((errno == EAGAIN || errno == EBUSY) && _inflight > 0)
+                {
+                    waitOne(); // 内核资源紧张：先收一个完成再重试
+                    continue;
+                }
+                // 提交失败：SQE 已在环里，只能拆掉 ring，剩下的都走同步写
+                fail(errno);
+                drainAndDisable();
+                return false;
+            }
+            slot.inflight = true;
+            _inflight++;
+            return true;
+        }
+
+        // 收割已完成的写入；一个都没有时 wait 为 true 则阻塞等待至少一个
+        void reap(bool wait)
+        {
+            unsigned head = *_cq_head;
+            if (wait && head == __atomic_load_n(_cq_tail, __ATOMIC_ACQUIRE))
+            {
+                while (::syscall(__NR_io_uring_enter, _ring_fd, 0u, 1u, static_cast<unsigned>(IORING_ENTER_GETEVENTS), nullptr, 0) < 0 &&
+                       errno == EINTR)
+                    ;
+            }
+            unsigned tail = __atomic_load_n(_cq_tail, __ATOMIC_ACQUIRE);
+            for (; head != tail; head++)
+            {
+                const struct io_uring_cqe &cqe = _cqes[head & _cq_mask];
+                complete(static_cast<size_t>(cqe.user_data), cqe.res);
+            }
+            __atomic_store_n(_cq_head, head, __ATOMIC_RELEASE);
+        }
+
+        void waitOne()
+        {
+            if (_ring_fd >= 0)
+                reap(true);
+        }
+
+        // 提交出错后把在途写入收完，之后一律同步写
+        void drainAndDisable()
+        {
+            while (_inflight > 0)
+                reap(true);
+            teardownRing();
+        }
+#else
+        void setupRing() {}
+        void teardownRing() {}
+        bool submit(size_t) { return false; }
+        void waitOne() {}
+#endif
+
+        // 一块缓冲的写入完成：出错记账，短写同步补齐，然后放回可用
+        void complete(size_t idx, int res)
+        {
+            Slot &slot = _slots[idx];
+            if (res < 0)
+                fail(-res);
+            else if (static_cast<size_t>(res) < slot.used)
+                pwriteAll(slot.buf + res, slot.used - res, slot.offset + res);
+            slot.inflight = false;
+            slot.used = 0;
+            _inflight--;
+        }
+
+        std::string _pathname;
+        int _fd = -1;
+        int _open_error = 0;
+        const size_t _cap;
+        std::vector<Slot> _slots;
+        size_t _cur = 0;      // 正在填充的缓冲
+        size_t _inflight = 0; // 在途写入数
+        uint64_t _offset = 0; // 下一块的文件偏移
+        int _last_error = 0;
+        size_t _errors = 0;
+
+        int _ring_fd = -1;
+#if MYLOG_HAVE_IO_URING
+        void *_sq_ring = nullptr;
+        size_t _sq_size = 0;
+        void *_cq_ring = nullptr; // 与 SQ 共用一次映射时为空
+        size_t _cq_size = 0;
+        struct io_uring_sqe *_sqes = nullptr;
+        size_t _sqes_size = 0;
+        unsigned *_sq_tail = nullptr;
+        unsigned _sq_mask = 0;
+        unsigned *_sq_array = nullptr;
+        unsigned *_cq_head = nullptr;
+        unsigned *_cq_tail = nullptr;
+        unsigned _cq_mask = 0;
+        struct io_uring_cqe *_cqes = nullptr;
+#endif
+    };
+}
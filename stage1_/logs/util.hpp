@@ -1,9 +1,10 @@
 /*
     通用功能类，与业务无关的功能实现
-        1. 获取系统时间
+        1. 获取系统时间（秒级 / 可切换时钟源的纳秒级）
         2. 获取文件大小
         3. 创建目录
         4. 获取文件所在目录
+        5. printf 风格格式化到复用缓冲区
 */
 #pragma once
 
@@ -12,14 +13,32 @@
 #include <cerrno>
 #include <cstring>
 #include <stdexcept>
+#include <cstdarg>
+#include <cstdio>
+#include <type_traits>
+#include <atomic>
+#include <cstdint>
+#include <ctime>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <unistd.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define MYLOG_HAS_TSC 1
+#endif
 
 namespace mylog
 {
     namespace util
     {
+        // 纳秒时间戳的来源
+        enum class ClockSource
+        {
+            COARSE,  // CLOCK_REALTIME_COARSE：最便宜，精度为一个时钟节拍（通常 1~4ms）
+            PRECISE, // CLOCK_REALTIME：vDSO 读取，纳秒精度
+            TSC      // rdtsc + 启动时校准：最便宜的高精度来源；非 x86 平台退化为 PRECISE
+        };
+
         class Date
         {
         public:
@@ -27,6 +46,138 @@ namespace mylog
             {
                 return (size_t)time(nullptr);
             }
+
+            // 按当前时钟源返回自 Epoch 起的纳秒数
+            static uint64_t nowNs()
+            {
+                switch (source().load(std::memory_order_relaxed))
+                {
+                case ClockSource::COARSE:
+                    return coarseNs();
+                case ClockSource::TSC:
+                    return tscNs();
+                default:
+                    return preciseNs();
+                }
+            }
+
+            // 进程级设置；切到 TSC 时完成校准
+            static void setClockSource(ClockSource src)
+            {
+                if (src == ClockSource::TSC)
+                    tsc();
+                source().store(src, std::memory_order_relaxed);
+            }
+            static ClockSource clockSource() { return source().load(std::memory_order_relaxed); }
+
+            static uint64_t coarseNs() { return clockNs(CLOCK_REALTIME_COARSE); }
+            static uint64_t preciseNs() { return clockNs(CLOCK_REALTIME); }
+            static uint64_t tscNs()
+            {
+#ifdef MYLOG_HAS_TSC
+                const Tsc &c = tsc();
+                return c.base_ns + static_cast<uint64_t>(static_cast<double>(__rdtsc() - c.base_tick) * c.ns_per_tick);
+#else
+                return preciseNs();
+#endif
+            }
+
+        private:
+            struct Tsc
+            {
+                uint64_t base_tick;
+                uint64_t base_ns;
+                double ns_per_tick;
+            };
+
+            static std::atomic<ClockSource> &source()
+            {
+                static std::atomic<ClockSource> src{ClockSource::PRECISE};
+                return src;
+            }
+
+            static uint64_t clockNs(clockid_t id)
+            {
+                struct timespec ts;
+                clock_gettime(id, &ts);
+                return static_cast<uint64_t>(ts.tv_sec) * 1000000000ull + static_cast<uint64_t>(ts.tv_nsec);
+            }
+
+            // 用约 5ms 的忙等把 tick 折算成纳秒，并以 CLOCK_REALTIME 作为零点
+            static const Tsc &tsc()
+            {
+                static const Tsc c = []
+                {
+                    Tsc r{0, 0, 1.0};
+#ifdef MYLOG_HAS_TSC
+                    uint64_t ns0 = clockNs(CLOCK_MONOTONIC), t0 = __rdtsc();
+                    uint64_t ns1 = ns0, t1 = t0;
+                    while (ns1 - ns0 < 5000000)
+                    {
+                        ns1 = clockNs(CLOCK_MONOTONIC);
+                        t1 = __rdtsc();
+                    }
+                    r.ns_per_tick = static_cast<double>(ns1 - ns0) / static_cast<double>(t1 - t0);
+                    r.base_tick = __rdtsc();
+                    r.base_ns = clockNs(CLOCK_REALTIME);
+#endif
+                    return r;
+                }();
+                return c;
+            }
+        };
+
+        class Printf
+        {
+        public:
+            // 能安全穿过 C 可变参数的类型：算术、枚举、指针；std::string 等类类型需先 .c_str()
+            template <typename T>
+            struct isArg : std::integral_constant<bool,
+                                                  std::is_arithmetic<std::decay_t<T>>::value ||
+                                                      std::is_enum<std::decay_t<T>>::value ||
+                                                      std::is_pointer<std::decay_t<T>>::value ||
+                                                      std::is_null_pointer<std::decay_t<T>>::value>
+            {
+            };
+
+            // 类型安全的格式化入口：参数类型在编译期检查，结果写入 out（复用其容量，稳态下无堆分配）
+            template <typename... Args>
+            static void format(std::string &out, const char *fmt, const Args &...args)
+            {
+                static_assert((isArg<Args>::value && ...),
+                              "mylog: printf 风格参数只接受算术/枚举/指针类型，std::string 请传 .c_str()");
+                formatImpl(out, fmt, args...);
+            }
+
+            static void vformat(std::string &out, const char *fmt, va_list ap)
+            {
+                // 先用已有容量试写，放不下再按精确长度扩一次
+                va_list cp;
+                va_copy(cp, ap);
+                out.resize(out.capacity());
+                int n = vsnprintf(&out[0], out.size() + 1, fmt, cp);
+                va_end(cp);
+                if (n < 0)
+                {
+                    out.clear();
+                    return;
+                }
+                if (static_cast<size_t>(n) > out.size())
+                {
+                    out.resize(n);
+                    vsnprintf(&out[0], out.size() + 1, fmt, ap);
+                }
+                out.resize(n);
+            }
+
+        private:
+            static void formatImpl(std::string &out, const char *fmt, ...)
+            {
+                va_list ap;
+                va_start(ap, fmt);
+                vformat(out, fmt, ap);
+                va_end(ap);
+            }
         };
 
         class File
@@ -0,0 +1,83 @@
+#include "logs/mylog.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <thread>
+#include <vector>
+
+using namespace mylog;
+
+// 慢落地：每批都停一会儿，迫使生产者用到多块缓冲区；同时检查每个线程的序号是否连续
+class SlowCheckSink : public LogSink
+{
+public:
+    virtual void log(const char *data, size_t len) override
+    {
+        std::string line(data, len);
+        if (line.find("dropped") != std::string::npos)
+            return; // 丢弃摘要行
+        int thr = 0, seq = 0;
+        std::sscanf(std::strchr(line.c_str(), '#'), "#%d %d", &thr, &seq);
+        auto it = _last.find(thr);
+        if (it != _last.end() && it->second >= seq)
+            _in_order = false;
+        if (it != _last.end() && it->second + 1 != seq)
+            _gaps++;
+        _last[thr] = seq;
+        _count++;
+    }
+    virtual void logBatch(const char *data, size_t len, const SinkRecord *records, size_t count) override
+    {
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+        LogSink::logBatch(data, len, records, count);
+    }
+    size_t _count = 0;
+    size_t _gaps = 0;
+    bool _in_order = true;
+
+private:
+    std::map<int, int> _last;
+};
+
+void run(const std::string &name, OverflowPolicy policy)
+{
+    const int threads = 4, per_thread = 50000;
+    auto sink = std::make_shared<SlowCheckSink>();
+    size_t dropped = 0;
+    {
+        std::vector<LogSink::ptr> sinks{sink};
+        AsyncOptions opts;
+        opts.overflow.policy = policy;
+        opts.pool.buffer_size = 64 * 1024;
+        opts.pool.budget = 1024 * 1024; // 16 块
+        auto lp = std::make_shared<AsyncLogger>(name, LogLevel::value::DEBUG,
+                                                std::make_shared<Formatter>("%m%n"), sinks, opts);
+        std::vector<std::thread> ths;
+        for (int t = 0; t < threads; t++)
+        {
+            ths.emplace_back([&, t]
+                             {
+                for (int i = 0; i < per_thread; i++)
+                    LOG_INFO(lp, "#%d %d", t, i); });
+        }
+        for (auto &th : ths)
+            th.join();
+        dropped = lp->droppedMessages();
+        lp.reset(); // 析构时把剩余数据写完
+    }
+    std::cout << name << ": 写入 " << threads * per_thread << " 条, 落地 " << sink->_count << " 条, 丢弃 " << dropped
+              << " 条 (" << (sink->_count + dropped == size_t(threads * per_thread) ? "一致" : "不一致") << "), 不连续 "
+              << sink->_gaps << " 处, 顺序 " << (sink->_in_order ? "正确" : "错误") << "\n";
+}
+
+int main()
+{
+    // BLOCK：预算内多块轮换，不丢也不乱序
+    run("pool_block", OverflowPolicy::BLOCK);
+    // DROP_OLDEST：预算用完时整块丢掉最早的数据，剩下的仍保持顺序
+    run("pool_drop_oldest", OverflowPolicy::DROP_OLDEST);
+    return 0;
+}
@@ -0,0 +1,35 @@
+#include "logs/mylog.h"
+
+#include <cstring>
+#include <iostream>
+#include <string>
+
+int main()
+{
+    using namespace mylog;
+
+    std::unique_ptr<LoggerBuilder> builder(new LocalLoggerBuilder());
+    builder->buildLoggerType(LoggerType::LOGGER_ASYNC);
+    builder->buildLoggerName("deferred_log");
+    builder->buildAsyncDeferred();
+    builder->buildLoggerFormatter("[%d{%H:%M:%S}][%t][%c][%f:%l][%p]%T%m%n");
+    builder->buildLoggerSink<StdoutSink>();
+    builder->buildLoggerSink<FileSink>("./logfile/test_deferred.log");
+    Logger::ptr logger = builder->build();
+
+    // 字符串参数按内容拷贝：生产者改写缓冲区后，后台线程仍应输出旧值
+    char name[32];
+    for (int i = 0; i < 5; i++)
+    {
+        snprintf(name, sizeof(name), "user-%d", i);
+        LOG_INFO(logger, "id=%d name=%s score=%.2f", i, name, i * 1.5);
+        std::memset(name, 'x', sizeof(name) - 1);
+    }
+    const char *np = nullptr;
+    LOG_WARN(logger, "null=%s ptr=%p", np, (void *)logger.get());
+    LOG_ERROR(logger, "无参数 100%%");
+
+    // std::string 格式串走 va_list 接口：无法延迟，生产者格式化后以 TEXT 记录入队
+    (logger->error)(std::string(__FILE__), __LINE__, std::string("va_list %s"), "ok");
+    return 0;
+}
@@ -0,0 +1,161 @@
+#include "logs/mylog.h"
+
+#include <dirent.h>
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace mylog;
+
+static std::string readAll(const std::string &path)
+{
+    std::ifstream ifs(path, std::ios::binary);
+    std::ostringstream oss;
+    oss << ifs.rdbuf();
+    return oss.str();
+}
+
+static size_t fileSize(const std::string &path)
+{
+    struct stat st{};
+    return ::stat(path.c_str(), &st) == 0 ? static_cast<size_t>(st.st_size) : 0;
+}
+
+static std::string makeLine(int i)
+{
+    return std::to_string(i) + ":" + std::string((i * 131) % 9000, 'a' + i % 26) + "\n";
+}
+
+// 1.DIRECT 模式与默认模式写出同样的内容，结果逐字节一致；文件原有（不满一块的）内容保留在前面，
+//   中途 flush() 之后文件长度就是实际长度，不带补齐的零
+static void checkSameAsBuffered(const std::string &dir, size_t buffer_size)
+{
+    const std::string ref_path = dir + "/direct_ref.log";
+    const std::string path = dir + "/direct_" + std::to_string(buffer_size) + ".log";
+    std::remove(ref_path.c_str());
+    std::remove(path.c_str());
+    util::File::createDirectory(dir);
+    {
+        std::ofstream(path) << "existing line\n";
+        std::ofstream(ref_path) << "existing line\n";
+    }
+    bool direct = false, size_ok = true;
+    {
+        FileSink ref(ref_path);
+        FileSink sink(path, FileMode::DIRECT, buffer_size);
+        direct = sink.directIO();
+        for (int i = 0; i < 5000; i++)
+        {
+            std::string line = makeLine(i);
+            ref.log(line.data(), line.size());
+            sink.log(line.data(), line.size());
+            if (i % 1000 == 999)
+            {
+                ref.flush();
+                sink.flush();
+                size_ok = size_ok && fileSize(path) == fileSize(ref_path);
+            }
+        }
+        std::string batch(3 * buffer_size + 123, 'b');
+        std::vector<SinkRecord> records{{batch.size(), LogLevel::value::INFO, 0}};
+        ref.logBatch(batch.data(), batch.size(), records.data(), records.size());
+        sink.logBatch(batch.data(), batch.size(), records.data(), records.size());
+    }
+    std::string expect = readAll(ref_path), got = readAll(path);
+    std::cout << dir << " 暂存 " << buffer_size << " 字节 (" << (direct ? "O_DIRECT" : "已退化为普通写入")
+              << "): 写入 " << expect.size() << " 字节, 内容" << (expect == got ? "一致" : "不一致")
+              << ", 每次 flush() 后文件长度" << (size_ok ? "正确" : "含补齐") << "\n";
+}
+
+// 2.RollBySizeSink 的 DIRECT 模式：每份文件不超过上限、不含补齐的零，按顺序拼起来就是写入的全部内容
+static void checkRollBySize()
+{
+    const std::string dir = "./logfile/direct_roll";
+    DIR *d = opendir(dir.c_str());
+    if (d)
+    {
+        while (struct dirent *e = readdir(d))
+            if (e->d_name[0] != '.')
+                std::remove((dir + "/" + e->d_name).c_str());
+        closedir(d);
+    }
+    const size_t max_size = 256 * 1024;
+    std::string expect;
+    bool direct = false;
+    {
+        RollBySizeSink sink(dir + "/roll", max_size, FileMode::DIRECT, 64 * 1024);
+        for (int i = 0; i < 3000; i++)
+        {
+            std::string line = makeLine(i);
+            expect += line;
+            sink.log(line.data(), line.size());
+            if (i % 500 == 0)
+                sink.flush();
+        }
+        direct = sink.directIO();
+    }
+    std::vector<std::string> files;
+    d = opendir(dir.c_str());
+    while (d)
+    {
+        struct dirent *e = readdir(d);
+        if (e == nullptr)
+            break;
+        if (e->d_name[0] != '.')
+            files.push_back(dir + "/" + e->d_name);
+    }
+    if (d)
+        closedir(d);
+    // 文件名里的时间不补零，不能按名字排序；每行带序号、内容唯一，按内容在原文中的位置排序
+    std::sort(files.begin(), files.end(), [&](const std::string &a, const std::string &b)
+              { return expect.find(readAll(a)) < expect.find(readAll(b)); });
+    std::string got;
+    bool size_ok = true, no_padding = true;
+    for (auto &f : files)
+    {
+        std::string content = readAll(f);
+        size_ok = size_ok && content.size() <= max_size;
+        no_padding = no_padding && content.find('\0') == std::string::npos;
+        got += content;
+    }
+    std::cout << "RollBySizeSink (" << (direct ? "O_DIRECT" : "已退化为普通写入") << "): " << files.size()
+              << " 份文件, 大小" << (size_ok ? "均不超过上限" : "超过上限") << ", " << (no_padding ? "不含" : "含有")
+              << "补齐的零, 拼接内容" << (got == expect ? "一致" : "不一致") << "\n";
+}
+
+int main()
+{
+    checkSameAsBuffered("./logfile", 4096);
+    checkSameAsBuffered("./logfile", 64 * 1024);
+    checkSameAsBuffered("./logfile", DEFAULT_DIRECT_BUFFER_SIZE);
+    // 较老内核的 tmpfs 不支持 O_DIRECT，会自动退化为普通写入，内容同样不变
+    if (util::File::exists("/dev/shm"))
+        checkSameAsBuffered("/dev/shm/mylog_direct_test", 64 * 1024);
+
+    checkRollBySize();
+
+    // 挂到异步日志器上，flush() 之后数据已在文件里，文件长度就是实际长度
+    {
+        const std::string path = "./logfile/direct_logger.log";
+        std::remove(path.c_str());
+        LocalLoggerBuilder builder;
+        builder.buildLoggerName("direct_sink");
+        builder.buildLoggerFormatter("%m%n");
+        builder.buildLoggerType(LoggerType::LOGGER_ASYNC);
+        builder.buildLoggerSink<FileSink>(path, FileMode::DIRECT);
+        Logger::ptr lp = builder.build();
+        for (int i = 0; i < 100000; i++)
+            LOG_INFO(lp, "line %d", i);
+        lp->flush();
+        std::string content = readAll(path);
+        size_t lines = std::count(content.begin(), content.end(), '\n');
+        std::cout << "异步日志器: 写入 100000 条, flush() 后文件中 " << lines << " 条, 文件长度 " << fileSize(path)
+                  << " 字节, " << (content.back() == '\n' ? "以换行结尾" : "结尾有多余字节") << "\n";
+    }
+    return 0;
+}
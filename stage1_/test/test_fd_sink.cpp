@@ -0,0 +1,85 @@
+#include "logs/mylog.h"
+
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace mylog;
+
+static std::string readAll(const std::string &path)
+{
+    std::ifstream ifs(path, std::ios::binary);
+    std::ostringstream oss;
+    oss << ifs.rdbuf();
+    return oss.str();
+}
+
+// 与 FileSink 写出同样的内容，结果必须逐字节一致；缓冲大小覆盖不缓冲、小于单条记录与默认大小
+static void checkSameAsFileSink(size_t buffer_size)
+{
+    const std::string ref_path = "./logfile/fd_sink_ref.log";
+    const std::string fd_path = "./logfile/fd_sink_" + std::to_string(buffer_size) + ".log";
+    std::remove(ref_path.c_str());
+    std::remove(fd_path.c_str());
+    {
+        FileSink ref(ref_path);
+        FdFileSink fd(fd_path, buffer_size);
+        for (int i = 0; i < 5000; i++)
+        {
+            std::string line = std::to_string(i) + ":" + std::string((i * 131) % 9000, 'a' + i % 26) + "\n";
+            ref.log(line.data(), line.size());
+            fd.log(line.data(), line.size());
+        }
+        // 一整批：既有放得进缓冲的，也有比缓冲大得多的
+        std::string batch(300 * 1024, 'b');
+        std::vector<SinkRecord> records{{batch.size(), LogLevel::value::INFO, 0}};
+        ref.logBatch(batch.data(), batch.size(), records.data(), records.size());
+        fd.logBatch(batch.data(), batch.size(), records.data(), records.size());
+    }
+    std::string expect = readAll(ref_path), got = readAll(fd_path);
+    std::cout << "缓冲 " << buffer_size << " 字节: 写入 " << expect.size() << " 字节, 内容"
+              << (expect == got ? "一致" : "不一致") << "\n";
+}
+
+int main()
+{
+    checkSameAsFileSink(0);
+    checkSameAsFileSink(4096);
+    checkSameAsFileSink(DEFAULT_FD_BUFFER_SIZE);
+
+    // 作为 FileSink 的替代品挂到异步日志器上，flush() 之后数据已在文件里
+    {
+        const std::string path = "./logfile/fd_sink_logger.log";
+        std::remove(path.c_str());
+        LocalLoggerBuilder builder;
+        builder.buildLoggerName("fd_sink");
+        builder.buildLoggerFormatter("%m%n");
+        builder.buildLoggerType(LoggerType::LOGGER_ASYNC);
+        builder.buildLoggerSink<FdFileSink>(path);
+        Logger::ptr lp = builder.build();
+        for (int i = 0; i < 1000; i++)
+            LOG_INFO(lp, "line %d", i);
+        lp->flush();
+        size_t lines = 0;
+        for (char c : readAll(path))
+            lines += c == '\n';
+        std::cout << "异步日志器: 写入 1000 条, flush() 后文件中 " << lines << " 条\n";
+    }
+
+    // 写失败不 assert，错误码返回给调用方
+    {
+        FdFileSink full("/dev/full", 0);
+        int err = full.append("x\n", 2);
+        std::cout << "/dev/full: append 返回 " << err << " (" << std::strerror(err) << "), 累计失败 "
+                  << full.errorCount() << " 次\n";
+        FdFileSink missing("/proc/no_such_dir/x.log");
+        missing.log("x\n", 2);
+        missing.flush();
+        std::cout << "无法创建的路径: 打开" << (missing.isOpen() ? "成功" : "失败") << ", 最近错误 "
+                  << std::strerror(missing.lastError()) << ", 累计失败 " << missing.errorCount() << " 次\n";
+    }
+    return 0;
+}
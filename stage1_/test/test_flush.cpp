@@ -0,0 +1,138 @@
+#include "logs/mylog.h"
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace mylog;
+
+// 数一数文件里已经落到系统的行数（ofstream 缓冲里的不算）
+static size_t fileLines(const std::string &path)
+{
+    std::ifstream ifs(path);
+    size_t n = 0;
+    std::string line;
+    while (std::getline(ifs, line))
+        n++;
+    return n;
+}
+
+static Logger::ptr makeLogger(const std::string &name, LoggerType type, void (*config)(LoggerBuilder &))
+{
+    const std::string path = "./logfile/flush_" + name + ".log";
+    std::remove(path.c_str());
+    LocalLoggerBuilder builder;
+    builder.buildLoggerName(name);
+    builder.buildLoggerFormatter("[%p] %m%n");
+    builder.buildLoggerType(type);
+    builder.buildLoggerSink<FileSink>(path);
+    if (config)
+        config(builder);
+    return builder.build();
+}
+
+// 1.flush() 返回时，此前写入的日志必须已经全部在文件里
+static void checkFlush(const std::string &name, LoggerType type, void (*config)(LoggerBuilder &))
+{
+    const std::string path = "./logfile/flush_" + name + ".log";
+    Logger::ptr lp = makeLogger(name, type, config);
+    const int threads = 4, per_thread = 5000;
+    std::vector<std::thread> ths;
+    for (int t = 0; t < threads; t++)
+    {
+        ths.emplace_back([&, t]
+                         {
+            for (int i = 0; i < per_thread; i++)
+                LOG_INFO(lp, "thread %d line %d", t, i); });
+    }
+    for (auto &th : ths)
+        th.join();
+    auto start = std::chrono::steady_clock::now();
+    lp->flush();
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    size_t lines = fileLines(path);
+    std::cout << name << ": 写入 " << threads * per_thread << " 条, flush() 后文件中 " << lines << " 条 ("
+              << (lines == size_t(threads * per_thread) ? "完整" : "缺失") << "), 耗时 " << ms << "ms\n";
+}
+
+// 2.flushOn(ERROR)：少量 INFO 留在 ofstream 缓冲里，一条 ERROR 写出后连同之前的一起刷到文件
+static void checkFlushOn(const std::string &name, LoggerType type)
+{
+    const std::string path = "./logfile/flush_" + name + ".log";
+    Logger::ptr lp = makeLogger(name, type, [](LoggerBuilder &b)
+                                { b.buildLoggerFlushOn(LogLevel::value::ERROR); });
+    for (int i = 0; i < 10; i++)
+        LOG_INFO(lp, "info %d", i);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    size_t before = fileLines(path);
+    LOG_ERROR(lp, "%s", "something failed");
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    size_t after = fileLines(path);
+    std::cout << name << ": 只写 INFO 时文件中 " << before << " 条, 写出 ERROR 后 " << after << " 条 ("
+              << (before == 0 && after == 11 ? "符合预期" : "不符合预期") << ")\n";
+}
+
+// 3.flushEvery(50ms)：写几行后什么也不做，稍等一会儿就应该都在文件里（空闲时也要刷新）
+static void checkFlushEvery(const std::string &name, LoggerType type, void (*config)(LoggerBuilder &))
+{
+    const std::string path = "./logfile/flush_" + name + ".log";
+    Logger::ptr lp = makeLogger(name, type, config);
+    lp->flushEvery(std::chrono::milliseconds(50));
+    for (int round = 0; round < 3; round++)
+    {
+        for (int i = 0; i < 10; i++)
+            LOG_INFO(lp, "round %d line %d", round, i);
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    }
+    size_t lines = fileLines(path);
+    std::cout << name << ": 分 3 轮各写 10 条, 每轮空闲 200ms 后文件中共 " << lines << " 条 ("
+              << (lines == 30 ? "已刷新" : "未刷新") << ")\n";
+}
+
+int main()
+{
+    checkFlush("sync", LoggerType::LOGGER_SYNC, nullptr);
+    checkFlush("async_mutex", LoggerType::LOGGER_ASYNC, nullptr);
+    checkFlush("async_ring", LoggerType::LOGGER_ASYNC, [](LoggerBuilder &b)
+               { b.buildAsyncLooperType(LooperType::LOOPER_RING); });
+    checkFlush("async_per_thread", LoggerType::LOGGER_ASYNC, [](LoggerBuilder &b)
+               { b.buildAsyncLooperType(LooperType::LOOPER_PER_THREAD); });
+    checkFlush("async_shared_pool", LoggerType::LOGGER_ASYNC, [](LoggerBuilder &b)
+               { b.buildAsyncSharedPool(); });
+    checkFlush("async_deferred", LoggerType::LOGGER_ASYNC, [](LoggerBuilder &b)
+               { b.buildAsyncDeferred(); });
+    checkFlush("async_buffer_pool", LoggerType::LOGGER_ASYNC, [](LoggerBuilder &b)
+               { b.buildAsyncBufferPool(64 * 1024, 1024 * 1024); });
+
+    // 缓冲很小且丢弃最旧记录：文件里的条数会少，但 flush() 必须能返回
+    {
+        Logger::ptr lp = makeLogger("async_drop_oldest", LoggerType::LOGGER_ASYNC, [](LoggerBuilder &b)
+                                    { b.buildAsyncBufferMax(16 * 1024);
+                                      b.buildAsyncOverflowPolicy(OverflowPolicy::DROP_OLDEST); });
+        std::thread producer([&]
+                             {
+            for (int i = 0; i < 200000; i++)
+                LOG_INFO(lp, "pressure %d", i); });
+        for (int i = 0; i < 20; i++)
+            lp->flush();
+        producer.join();
+        lp->flush();
+        std::cout << "async_drop_oldest: 写入压力下 21 次 flush() 全部返回\n";
+    }
+
+    checkFlushOn("sync_flush_on", LoggerType::LOGGER_SYNC);
+    checkFlushOn("async_flush_on", LoggerType::LOGGER_ASYNC);
+
+    checkFlushEvery("sync_every", LoggerType::LOGGER_SYNC, nullptr);
+    checkFlushEvery("async_mutex_every", LoggerType::LOGGER_ASYNC, nullptr);
+    checkFlushEvery("async_ring_every", LoggerType::LOGGER_ASYNC, [](LoggerBuilder &b)
+                    { b.buildAsyncLooperType(LooperType::LOOPER_RING); });
+    checkFlushEvery("async_per_thread_every", LoggerType::LOGGER_ASYNC, [](LoggerBuilder &b)
+                    { b.buildAsyncLooperType(LooperType::LOOPER_PER_THREAD); });
+    checkFlushEvery("async_shared_pool_every", LoggerType::LOGGER_ASYNC, [](LoggerBuilder &b)
+                    { b.buildAsyncSharedPool(); });
+    return 0;
+}
@@ -0,0 +1,69 @@
+#include "logs/mylog.h"
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace mylog;
+
+static constexpr char kPattern[] = "[%d{%H:%M:%S.%3N}][%t][%c][%f:%l][%p]%T%m%n";
+
+// 收集落地的每条记录，和同步格式化的结果逐条比对
+class CollectSink : public LogSink
+{
+public:
+    virtual void log(const char *data, size_t len) override
+    {
+        _records.emplace_back(data, len);
+    }
+    std::vector<std::string> _records;
+};
+
+// formatTo 与 format 的结果必须一致；空间不够时只返回所需长度
+template <typename F>
+bool checkFormatTo(const F &fmt, const LogMsg &msg)
+{
+    std::string expect;
+    fmt.format(expect, msg);
+    std::vector<char> dst(expect.size() + 16, '#');
+    if (fmt.formatTo(dst.data(), dst.size(), msg) != expect.size() ||
+        std::string(dst.data(), expect.size()) != expect || dst[expect.size()] != '#')
+        return false;
+    // 空间差一个字节：长度照常返回，且不能越界
+    std::vector<char> small(expect.size() - 1 + 16, '#');
+    if (fmt.formatTo(small.data(), expect.size() - 1, msg) != expect.size())
+        return false;
+    for (size_t i = expect.size() - 1; i < small.size(); i++)
+        if (small[i] != '#')
+            return false;
+    return true;
+}
+
+int main()
+{
+    LogMsg msg("inplace", "test_inplace.cpp", 42, std::string("payload with\nnewline"), LogLevel::value::WARN);
+    Formatter dyn(kPattern);
+    StaticFormatter<kPattern> stat;
+    std::cout << "formatTo 与 format 一致: 动态 " << (checkFormatTo(dyn, msg) ? "是" : "否")
+              << ", 编译期 " << (checkFormatTo(stat, msg) ? "是" : "否") << "\n";
+
+    // 异步日志器：小缓冲上限让一部分写入因空间不足回退到整条拷贝，两条路径的结果都要正确
+    auto sink = std::make_shared<CollectSink>();
+    const int count = 20000;
+    std::vector<std::string> payloads;
+    for (int i = 0; i < count; i++)
+        payloads.push_back(std::to_string(i) + ":" + std::string((i * 37) % 3000, 'a' + i % 26));
+    {
+        std::vector<LogSink::ptr> sinks{sink};
+        auto lp = std::make_shared<AsyncLogger>("inplace", LogLevel::value::DEBUG,
+                                                std::make_shared<Formatter>("[%p] %m|%n"), sinks);
+        lp->setMaxBufferSize(64 * 1024);
+        for (int i = 0; i < count; i++)
+            LOG_INFO(lp, "%s", payloads[i].c_str());
+    }
+    size_t wrong = 0;
+    for (size_t i = 0; i < sink->_records.size(); i++)
+        wrong += sink->_records[i] != "[INFO] " + payloads[i] + "|\r\n";
+    std::cout << "写入: " << count << " 条, 落地: " << sink->_records.size() << " 条, 内容不符: " << wrong << " 条\n";
+    return 0;
+}
@@ -0,0 +1,71 @@
+#include "logs/mylog.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+using namespace mylog;
+
+static std::string readAll(const std::string &path)
+{
+    std::ifstream ifs(path, std::ios::binary);
+    std::ostringstream oss;
+    oss << ifs.rdbuf();
+    return oss.str();
+}
+
+// 便捷宏的格式串既可以是字面量，也可以是运行期得到的 const char* / char 数组 / std::string；
+// 后者每次调用立即格式化，开启延迟格式化的日志器也一样（调用返回后格式串可以被改写）
+static void check(const std::string &name, bool deferred)
+{
+    const std::string path = "./logfile/macro_fmt_" + name + ".log";
+    std::remove(path.c_str());
+    LocalLoggerBuilder builder;
+    builder.buildLoggerName("macro_fmt_" + name);
+    builder.buildLoggerFormatter("%m%n");
+    builder.buildLoggerType(deferred ? LoggerType::LOGGER_ASYNC : LoggerType::LOGGER_SYNC);
+    if (deferred)
+        builder.buildAsyncDeferred();
+    builder.buildLoggerSink<FileSink>(path);
+    Logger::ptr lp = builder.build();
+
+    const char *ptr_fmt = "pointer %d";
+    char buf_fmt[32];
+    std::snprintf(buf_fmt, sizeof(buf_fmt), "%s", "buffer %d");
+    std::string str_fmt = "string %d";
+
+    lp->info("literal %d", 1);
+    lp->info(ptr_fmt, 2);
+    lp->warn(buf_fmt, 3);
+    std::snprintf(buf_fmt, sizeof(buf_fmt), "%s", "overwritten %d");
+    LOG_ERROR(lp, ptr_fmt, 4);
+    lp->info(str_fmt, 5);
+    lp->info(str_fmt + " %s", 6, "temp"); // 临时 std::string
+    LOG_WARN(lp, str_fmt, 7);
+    {
+        char stack_fmt[32]; // 调用返回后即失效的格式串，直接调用 (file, line, fmt) 接口
+        std::snprintf(stack_fmt, sizeof(stack_fmt), "%s", "stack %d");
+        (lp->info)(__FILE__, __LINE__, stack_fmt, 8);
+        std::snprintf(stack_fmt, sizeof(stack_fmt), "%s", "overwritten %d");
+    }
+    // LOG_xxx 是表达式，可以放进条件表达式和逗号表达式
+    bool on = true;
+    on ? LOG_INFO(lp, "ternary %d", 9) : void();
+    (LOG_INFO(lp, "comma %d", 10), LOG_INFO(lp, ptr_fmt, 11));
+    lp->flush();
+
+    const std::string expect = "literal 1\npointer 2\nbuffer 3\npointer 4\nstring 5\nstring 6 temp\nstring 7\nstack 8\nternary 9\ncomma 10\npointer 11\n";
+    std::string got = readAll(path);
+    got.erase(std::remove(got.begin(), got.end(), '\r'), got.end()); // %n 输出 \r\n
+    std::cout << name << ": 字面量 / const char* / char 数组 / std::string 格式串输出" << (got == expect ? "正确" : "错误:\n" + got) << "\n";
+}
+
+int main()
+{
+    check("sync", false);
+    check("deferred", true);
+    return 0;
+}
@@ -0,0 +1,172 @@
+#include "logs/mylog.h"
+
+#include <dirent.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace mylog;
+
+static std::string readAll(const std::string &path)
+{
+    std::ifstream ifs(path, std::ios::binary);
+    std::ostringstream oss;
+    oss << ifs.rdbuf();
+    return oss.str();
+}
+
+static std::vector<std::string> listDir(const std::string &dir)
+{
+    std::vector<std::string> files;
+    DIR *d = opendir(dir.c_str());
+    if (d == nullptr)
+        return files;
+    while (struct dirent *e = readdir(d))
+        if (e->d_name[0] != '.')
+            files.push_back(dir + "/" + e->d_name);
+    closedir(d);
+    return files;
+}
+
+static void clearDir(const std::string &dir)
+{
+    for (auto &f : listDir(dir))
+        std::remove(f.c_str());
+}
+
+static std::string makeLine(int i)
+{
+    return std::to_string(i) + ":" + std::string((i * 131) % 9000, 'a' + i % 26) + "\n";
+}
+
+// 1.每份文件不超过上限、滚动后截回实际长度（不含预分配留下的零），按顺序拼起来就是写入的全部内容；
+//   单条记录比 max_size 还大时扩大映射照常写入
+static void checkRollBySize()
+{
+    const std::string dir = "./logfile/mmap_roll";
+    clearDir(dir);
+    const size_t max_size = 256 * 1024;
+    std::string expect;
+    bool mapped = false;
+    {
+        RollBySizeSink sink(dir + "/roll", max_size, FileMode::MMAP);
+        for (int i = 0; i < 3000; i++)
+        {
+            std::string line = makeLine(i);
+            expect += line;
+            sink.log(line.data(), line.size());
+            if (i % 500 == 0)
+                sink.flush();
+        }
+        mapped = sink.mapped();
+        // 一批里有一条超过 max_size 的大记录
+        std::string big = "big:" + std::string(max_size + 1000, 'B') + "\n";
+        std::string tail = makeLine(3000);
+        std::string batch = big + tail;
+        std::vector<SinkRecord> records{{big.size(), LogLevel::value::INFO, 0}, {tail.size(), LogLevel::value::INFO, 0}};
+        sink.logBatch(batch.data(), batch.size(), records.data(), records.size());
+        expect += batch;
+    }
+    std::vector<std::string> files = listDir(dir);
+    // 文件名里的时间不补零，不能按名字排序；每行带序号、内容唯一，按内容在原文中的位置排序
+    std::sort(files.begin(), files.end(), [&](const std::string &a, const std::string &b)
+              { return expect.find(readAll(a)) < expect.find(readAll(b)); });
+    std::string got;
+    size_t oversize = 0;
+    bool no_padding = true;
+    for (auto &f : files)
+    {
+        std::string content = readAll(f);
+        oversize += content.size() > max_size;
+        no_padding = no_padding && content.find('\0') == std::string::npos;
+        got += content;
+    }
+    std::cout << "RollBySizeSink (" << (mapped ? "映射写入" : "已退化为 pwrite") << "): " << files.size()
+              << " 份文件, 超过上限的 " << oversize << " 份 (只应是那条大记录), " << (no_padding ? "不含" : "含有")
+              << "预分配的零, 拼接内容" << (got == expect ? "一致" : "不一致") << "\n";
+}
+
+// 2.子进程写完不析构、直接 _exit：映射里的数据已在页缓存中，文件里一条不少（末尾是预分配的零）；
+//   作为对照，默认模式留在 ofstream 缓冲里的数据随进程一起丢失
+static void checkCrash(FileMode mode, const std::string &name)
+{
+    const std::string dir = "./logfile/mmap_crash_" + name;
+    clearDir(dir);
+    const int lines = 1000;
+    pid_t pid = fork();
+    if (pid == 0)
+    {
+        RollBySizeSink *sink = new RollBySizeSink(dir + "/crash", 4 * 1024 * 1024, mode);
+        for (int i = 0; i < lines; i++)
+        {
+            std::string line = "line " + std::to_string(i) + "\n";
+            sink->log(line.data(), line.size());
+        }
+        _exit(0); // 不调用析构，也不刷新任何缓冲
+    }
+    waitpid(pid, nullptr, 0);
+    std::vector<std::string> files = listDir(dir);
+    std::string content = files.empty() ? "" : readAll(files[0]);
+    size_t file_size = content.size();
+    content.erase(content.find_last_not_of('\0') + 1); // 去掉末尾预分配的零
+    size_t found = std::count(content.begin(), content.end(), '\n');
+    std::cout << name << ": 子进程写入 " << lines << " 条后直接退出, 文件长度 " << file_size << " 字节, 去掉末尾的零后有 "
+              << found << " 条\n";
+}
+
+int main()
+{
+    checkRollBySize();
+    checkCrash(FileMode::MMAP, "mmap");
+    checkCrash(FileMode::BUFFERED, "buffered");
+
+    // FileSink 没有大小上限，传入 MMAP 时按 BUFFERED 写入
+    {
+        const std::string path = "./logfile/mmap_filesink.log";
+        std::remove(path.c_str());
+        std::string expect;
+        {
+            FileSink sink(path, FileMode::MMAP);
+            for (int i = 0; i < 100; i++)
+            {
+                std::string line = makeLine(i);
+                expect += line;
+                sink.log(line.data(), line.size());
+            }
+        }
+        std::cout << "FileSink 传入 MMAP: 按 BUFFERED 写入, 内容" << (readAll(path) == expect ? "一致" : "不一致") << "\n";
+    }
+
+    // 挂到异步日志器上，日志器析构后各份文件截回实际长度，条数完整
+    {
+        const std::string dir = "./logfile/mmap_logger";
+        clearDir(dir);
+        {
+            LocalLoggerBuilder builder;
+            builder.buildLoggerName("mmap_sink");
+            builder.buildLoggerFormatter("%m%n");
+            builder.buildLoggerType(LoggerType::LOGGER_ASYNC);
+            builder.buildLoggerSink<RollBySizeSink>(dir + "/async", 512 * 1024, FileMode::MMAP);
+            Logger::ptr lp = builder.build();
+            for (int i = 0; i < 100000; i++)
+                LOG_INFO(lp, "line %d", i);
+        }
+        size_t lines = 0, zeros = 0;
+        std::vector<std::string> files = listDir(dir);
+        for (auto &f : files)
+        {
+            std::string content = readAll(f);
+            lines += std::count(content.begin(), content.end(), '\n');
+            zeros += std::count(content.begin(), content.end(), '\0');
+        }
+        std::cout << "异步日志器: 写入 100000 条, " << files.size() << " 份文件中共 " << lines << " 条, 残留的零 "
+                  << zeros << " 字节\n";
+    }
+    return 0;
+}
@@ -0,0 +1,72 @@
+#include "logs/mylog.h"
+
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+
+using namespace mylog;
+
+// 故意很慢的落地：每条 20us，让异步缓冲区很快写满
+class SlowSink : public LogSink
+{
+public:
+    virtual void log(const char *data, size_t len) override
+    {
+        if (len > 0 && std::strstr(std::string(data, len).c_str(), "messages dropped"))
+        {
+            _summaries++;
+            std::cout << "  摘要: " << std::string(data, len);
+            return;
+        }
+        _count++;
+        std::this_thread::sleep_for(std::chrono::microseconds(20));
+    }
+    size_t _count = 0;
+    size_t _summaries = 0;
+};
+
+void run(const char *name, LooperType looper, OverflowPolicy policy)
+{
+    const size_t total = 20000;
+    auto sink = std::make_shared<SlowSink>();
+    size_t dropped = 0;
+    auto start = std::chrono::steady_clock::now();
+    {
+        // 直接构造异步日志器以便挂上计数用的 sink；等价于 buildAsyncLooperType + buildAsyncOverflowPolicy
+        std::vector<LogSink::ptr> sinks{sink};
+        AsyncOptions opts;
+        opts.looper = looper;
+        opts.ring_size = 64 * 1024;
+        opts.overflow.policy = policy;
+        opts.overflow.timeout = std::chrono::milliseconds(1);
+        auto alp = std::make_shared<AsyncLogger>(name, LogLevel::value::DEBUG, std::make_shared<Formatter>("%p %m%n"), sinks, opts);
+        alp->setMaxBufferSize(64 * 1024);
+        for (size_t i = 0; i < total; i++)
+        {
+            if (i % 10 == 0)
+                LOG_ERROR(alp, "message %zu padding padding padding padding padding", i);
+            else
+                LOG_INFO(alp, "message %zu padding padding padding padding padding", i);
+        }
+        dropped = alp->droppedMessages();
+    }
+    double cost = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << name << ": 写入 " << total << ", 落地 " << sink->_count << ", 丢弃 " << dropped
+              << (sink->_count + dropped == total ? " (一致)" : " (不一致)") << ", 摘要行 " << sink->_summaries
+              << ", 耗时 " << cost << "s\n";
+}
+
+int main()
+{
+    run("block", LooperType::LOOPER_MUTEX, OverflowPolicy::BLOCK);
+    run("block_timeout", LooperType::LOOPER_MUTEX, OverflowPolicy::BLOCK_TIMEOUT);
+    run("drop_newest", LooperType::LOOPER_MUTEX, OverflowPolicy::DROP_NEWEST);
+    run("drop_oldest", LooperType::LOOPER_MUTEX, OverflowPolicy::DROP_OLDEST);
+    run("drop_below_level", LooperType::LOOPER_MUTEX, OverflowPolicy::DROP_BELOW_LEVEL);
+    run("ring_drop_newest", LooperType::LOOPER_RING, OverflowPolicy::DROP_NEWEST);
+    run("ring_block_timeout", LooperType::LOOPER_RING, OverflowPolicy::BLOCK_TIMEOUT);
+    run("per_thread_drop_newest", LooperType::LOOPER_PER_THREAD, OverflowPolicy::DROP_NEWEST);
+    return 0;
+}
@@ -0,0 +1,76 @@
+#include "logs/mylog.h"
+
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <thread>
+#include <vector>
+
+using namespace mylog;
+
+// 统计条数，并检查每个生产线程的序号是否连续（一个 sink 只属于一个日志器，由池串行调用）
+class CheckSink : public LogSink
+{
+public:
+    virtual void log(const char *data, size_t len) override
+    {
+        std::string line(data, len);
+        int thr = 0, seq = 0;
+        std::sscanf(std::strchr(line.c_str(), '#'), "#%d %d", &thr, &seq);
+        auto it = _last.find(thr);
+        if (it != _last.end() && it->second + 1 != seq)
+            _in_order = false;
+        _last[thr] = seq;
+        _count++;
+    }
+    size_t _count = 0;
+    bool _in_order = true;
+
+private:
+    std::map<int, int> _last;
+};
+
+int main()
+{
+    const int loggers = 64, threads = 4, per_thread = 5000;
+    std::vector<std::shared_ptr<CheckSink>> sinks;
+    {
+        std::vector<Logger::ptr> lps;
+        for (int i = 0; i < loggers; i++)
+        {
+            sinks.push_back(std::make_shared<CheckSink>());
+            std::vector<LogSink::ptr> s{sinks.back()};
+            AsyncOptions opts;
+            opts.looper = LooperType::LOOPER_SHARED_POOL;
+            opts.pool_threads = 2;
+            lps.push_back(std::make_shared<AsyncLogger>("pool" + std::to_string(i), LogLevel::value::DEBUG,
+                                                        std::make_shared<Formatter>("%m%n"), s, opts));
+        }
+        // 64 个日志器只占用池里的 2 条后台线程
+        std::cout << "日志器: " << loggers << " 个, 后台线程: " << LooperPool::getInstance().threadCount() << " 条\n";
+
+        // 每个线程轮流写所有日志器
+        std::vector<std::thread> ths;
+        for (int t = 0; t < threads; t++)
+        {
+            ths.emplace_back([&, t]
+                             {
+                for (int i = 0; i < per_thread; i++)
+                    LOG_INFO(lps[(t + i) % loggers], "#%d %d", t, i / loggers); });
+        }
+        for (auto &th : ths)
+            th.join();
+    } // 日志器析构：等待池处理完各自的数据
+
+    size_t total = 0;
+    bool in_order = true;
+    for (auto &s : sinks)
+    {
+        total += s->_count;
+        in_order = in_order && s->_in_order;
+    }
+    std::cout << "写入: " << threads * per_thread << " 条, 落地: " << total << " 条\n";
+    std::cout << "日志器内顺序: " << (in_order ? "正确" : "错误") << "\n";
+    return 0;
+}
@@ -0,0 +1,73 @@
+#include "logs/mylog.h"
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace mylog;
+
+// 旧式落地：每次 log() 都应恰好是一条完整日志（多行消息也不能被拆开）
+class RecordSink : public LogSink
+{
+public:
+    virtual void log(const char *data, size_t len) override
+    {
+        std::string rec(data, len);
+        if (rec.rfind("BEGIN", 0) != 0 || rec.find("END\n") != rec.size() - 4)
+            _broken++;
+        _count++;
+    }
+    size_t _count = 0;
+    size_t _broken = 0;
+};
+
+// 按记录头里的等级分流：只看 SinkRecord，不解析文本
+class LevelSink : public LogSink
+{
+public:
+    virtual void log(const char *, size_t) override {}
+    virtual void logBatch(const char *, size_t, const SinkRecord *records, size_t count) override
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            if (records[i].level >= LogLevel::value::ERROR)
+                _errors++;
+            if (records[i].logger != _logger_id)
+                _wrong_logger++;
+        }
+    }
+    uint32_t _logger_id = 0;
+    size_t _errors = 0;
+    size_t _wrong_logger = 0;
+};
+
+int main()
+{
+    const int count = 20000;
+    // 模拟堆栈/JSON：消息本身带多处换行
+    const char *trace = "line one\n  at frame 1\n  at frame 2\n{\"k\": [1,\n 2]}";
+    for (bool deferred : {false, true})
+    {
+        auto rec_sink = std::make_shared<RecordSink>();
+        auto level_sink = std::make_shared<LevelSink>();
+        {
+            std::vector<LogSink::ptr> sinks{rec_sink, level_sink};
+            AsyncOptions opts;
+            opts.deferred = deferred;
+            auto lp = std::make_shared<AsyncLogger>("framing", LogLevel::value::DEBUG,
+                                                    std::make_shared<Formatter>("BEGIN [%p] %m END\n"), sinks, opts);
+            level_sink->_logger_id = lp->id();
+            for (int i = 0; i < count; i++)
+            {
+                if (i % 4 == 0)
+                    LOG_ERROR(lp, "%d %s", i, trace);
+                else
+                    LOG_INFO(lp, "%d %s", i, trace);
+            }
+        }
+        std::cout << (deferred ? "延迟格式化" : "普通异步") << ": 写入 " << count << " 条, 落地 " << rec_sink->_count
+                  << " 条, 被拆开 " << rec_sink->_broken << " 条, ERROR " << level_sink->_errors
+                  << " 条, 日志器 id 不符 " << level_sink->_wrong_logger << " 条\n";
+    }
+    return 0;
+}
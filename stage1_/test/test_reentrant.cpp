@@ -0,0 +1,52 @@
+#include "logs/mylog.h"
+
+#include <iostream>
+#include <string>
+
+using namespace mylog;
+
+// 收到日志后先通过另一个日志器写一条（在日志调用内部再写日志），再保存自己拿到的文本
+class ReentrantSink : public LogSink
+{
+public:
+    ReentrantSink(Logger::ptr inner, std::string *out) : _inner(inner), _out(out) {}
+    void log(const char *data, size_t len) override
+    {
+        if (_inner)
+            LOG_INFO(_inner, "inner %d %s", 2, "xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx");
+        _out->append(data, len);
+    }
+
+private:
+    Logger::ptr _inner;
+    std::string *_out;
+};
+
+static Logger::ptr syncLogger(const std::string &name, Logger::ptr inner, std::string *out)
+{
+    LocalLoggerBuilder builder;
+    builder.buildLoggerName(name);
+    builder.buildLoggerFormatter("[%c] %m\n");
+    builder.buildLoggerType(LoggerType::LOGGER_SYNC);
+    builder.buildLoggerSink<ReentrantSink>(inner, out);
+    return builder.build();
+}
+
+int main()
+{
+    std::string inner_out, outer_out;
+    Logger::ptr inner = syncLogger("inner", nullptr, &inner_out);
+    Logger::ptr outer = syncLogger("outer", inner, &outer_out);
+
+    LOG_INFO(outer, "outer %d", 1);
+    {
+        std::string fmt = "outer %d"; // 运行期格式串走另一条路径
+        outer->info(fmt, 3);
+    }
+
+    const std::string expect_outer = "[outer] outer 1\n[outer] outer 3\n";
+    const std::string line = "[inner] inner 2 xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx\n";
+    bool ok = outer_out == expect_outer && inner_out == line + line;
+    std::cout << "落地中再写日志，外层消息" << (ok ? "不受影响" : "被覆盖:\n" + outer_out + inner_out) << "\n";
+    return ok ? 0 : 1;
+}
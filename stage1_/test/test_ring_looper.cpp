@@ -0,0 +1,189 @@
+#include "logs/mylog.h"
+#include "logs/ring_looper.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace mylog;
+
+// 回调收到的是首尾相接的记录，每条形如 "<线程> <序号> <填充>\n"；
+// 统计条数，并检查同一线程的序号只增不减（BLOCK 下还必须连续）
+struct Checker
+{
+    void operator()(Buffer &buf)
+    {
+        const char *p = buf.readPtr(), *end = p + buf.readableSize();
+        while (p < end)
+        {
+            const char *nl = static_cast<const char *>(std::memchr(p, '\n', end - p));
+            if (nl == nullptr)
+            {
+                broken++; // 记录被截断
+                break;
+            }
+            int thr = 0, seq = 0;
+            if (std::sscanf(p, "%d %d", &thr, &seq) != 2)
+                broken++;
+            auto it = last.find(thr);
+            if (it != last.end() && (seq <= it->second || (contiguous && seq != it->second + 1)))
+                in_order = false;
+            last[thr] = seq;
+            count++;
+            p = nl + 1;
+        }
+    }
+    bool contiguous = true;
+    size_t count = 0, broken = 0;
+    bool in_order = true;
+    std::map<int, int> last;
+};
+
+static std::string makeRecord(int thr, int seq)
+{
+    std::string rec = std::to_string(thr) + " " + std::to_string(seq) + " ";
+    rec.append(static_cast<size_t>((seq * 37 + thr * 11) % 300), 'a' + thr % 26); // 长短不一，记录会跨越环的末尾
+    rec += '\n';
+    return rec;
+}
+
+// 多个生产者写一个很小的环：环一直是满的、不停回绕；写完立即 stop()，已返回的 push 一条都不能丢。
+// 消费者频繁在睡与醒之间切换，漏掉一次唤醒就要等 100ms 超时，总耗时会从几十毫秒涨到几十秒
+static void checkFullRing(int threads, int per_thread, size_t ring_size)
+{
+    Checker checker;
+    auto start = std::chrono::steady_clock::now();
+    size_t dropped = 0;
+    {
+        RingLooper looper([&](Buffer &buf)
+                          { checker(buf); }, ring_size);
+        std::vector<std::thread> ths;
+        for (int t = 0; t < threads; t++)
+        {
+            ths.emplace_back([&, t]
+                             {
+                for (int i = 0; i < per_thread; i++)
+                {
+                    std::string rec = makeRecord(t, i);
+                    looper.push(rec.data(), rec.size(), LogLevel::value::INFO);
+                } });
+        }
+        for (auto &th : ths)
+            th.join();
+        looper.stop();
+        dropped = looper.droppedMessages();
+    }
+    double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << threads << " 个生产者 x " << per_thread << " 条, 环 " << ring_size << " 字节: 落地 " << checker.count
+              << " 条 (" << (checker.count == size_t(threads * per_thread) ? "完整" : "缺失") << "), 丢弃 " << dropped
+              << " 条, 线程内顺序" << (checker.in_order ? "正确" : "错误") << ", 截断 " << checker.broken << " 条, 耗时 "
+              << secs << "s (" << (secs < 5 ? "正常" : "过长，消费者可能漏掉了唤醒") << ")\n";
+}
+
+// 比整个环还大的记录直接丢弃并计数，前后的记录照常落地
+static void checkOversized()
+{
+    Checker checker;
+    size_t dropped = 0;
+    {
+        RingLooper looper([&](Buffer &buf)
+                          { checker(buf); }, 4096);
+        std::string small = makeRecord(0, 0), big = "0 1 " + std::string(8192, 'x') + "\n", next = makeRecord(0, 2);
+        looper.push(small.data(), small.size(), LogLevel::value::INFO);
+        looper.push(big.data(), big.size(), LogLevel::value::INFO);
+        looper.push(next.data(), next.size(), LogLevel::value::INFO);
+        looper.stop();
+        dropped = looper.droppedMessages();
+    }
+    std::cout << "超过环大小的记录: 落地 " << checker.count << " 条 (应为 2), 丢弃 " << dropped << " 条 (应为 1)\n";
+}
+
+// DROP_NEWEST：回调很慢时放不下的记录被丢弃，落地 + 丢弃 = 写入，落地的记录仍按线程内顺序
+static void checkDropNewest()
+{
+    Checker checker;
+    checker.contiguous = false;
+    const int threads = 4, per_thread = 20000;
+    size_t dropped = 0;
+    {
+        OverflowConfig overflow;
+        overflow.policy = OverflowPolicy::DROP_NEWEST;
+        RingLooper looper([&](Buffer &buf)
+                          {
+            checker(buf);
+            std::this_thread::sleep_for(std::chrono::microseconds(200)); }, 4096, overflow);
+        std::vector<std::thread> ths;
+        for (int t = 0; t < threads; t++)
+        {
+            ths.emplace_back([&, t]
+                             {
+                for (int i = 0; i < per_thread; i++)
+                {
+                    std::string rec = makeRecord(t, i);
+                    looper.push(rec.data(), rec.size(), LogLevel::value::WARN);
+                } });
+        }
+        for (auto &th : ths)
+            th.join();
+        looper.stop();
+        dropped = looper.droppedMessages();
+    }
+    std::cout << "DROP_NEWEST: 写入 " << threads * per_thread << " 条, 落地 " << checker.count << " + 丢弃 " << dropped
+              << " = " << checker.count + dropped << ", 线程内顺序" << (checker.in_order ? "正确" : "错误") << "\n";
+}
+
+// 生产者还在写时 stop()：停止前后写入的记录要么落地、要么计入丢弃，不会悄悄丢失，生产者也不会卡住
+static void checkStopRace(OverflowPolicy policy, const std::string &name)
+{
+    Checker checker;
+    checker.contiguous = false;
+    const int threads = 4, per_thread = 20000;
+    size_t dropped = 0;
+    {
+        OverflowConfig overflow;
+        overflow.policy = policy;
+        RingLooper looper([&](Buffer &buf)
+                          { checker(buf); }, 4096, overflow);
+        std::atomic<int> started{0};
+        std::vector<std::thread> ths;
+        for (int t = 0; t < threads; t++)
+        {
+            ths.emplace_back([&, t]
+                             {
+                started++;
+                for (int i = 0; i < per_thread; i++)
+                {
+                    std::string rec = makeRecord(t, i);
+                    looper.push(rec.data(), rec.size(), LogLevel::value::WARN);
+                } });
+        }
+        while (started < threads)
+            std::this_thread::yield();
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        looper.stop();
+        for (auto &th : ths)
+            th.join();
+        dropped = looper.droppedMessages();
+    }
+    std::cout << name << " 写入中途 stop(): 写入 " << threads * per_thread << " 条, 落地 " << checker.count << " + 丢弃 "
+              << dropped << " = " << checker.count + dropped << " ("
+              << (checker.count + dropped == size_t(threads * per_thread) ? "一致" : "不一致") << ")\n";
+}
+
+int main()
+{
+    checkFullRing(2, 20000, 4096);
+    checkFullRing(4, 20000, 4096);
+    checkFullRing(8, 20000, 64 * 1024);
+    checkOversized();
+    checkDropNewest();
+    checkStopRace(OverflowPolicy::BLOCK, "BLOCK");
+    checkStopRace(OverflowPolicy::DROP_NEWEST, "DROP_NEWEST");
+    return 0;
+}
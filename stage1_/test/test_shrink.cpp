@@ -0,0 +1,115 @@
+#include "logs/mylog.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <unistd.h>
+
+using namespace mylog;
+
+// 落地在放行前一直卡住，让生产缓冲区在突发期间一路扩容
+static std::atomic<bool> g_open{true};
+
+class GateSink : public LogSink
+{
+public:
+    virtual void log(const char *, size_t) override { wait(); }
+    virtual void logBatch(const char *, size_t, const SinkRecord *, size_t) override { wait(); }
+
+private:
+    void wait()
+    {
+        while (!g_open.load())
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+};
+
+static size_t rssMB()
+{
+    long pages = 0, resident = 0;
+    FILE *fp = std::fopen("/proc/self/statm", "r");
+    if (fp)
+    {
+        if (std::fscanf(fp, "%ld %ld", &pages, &resident) != 2)
+            resident = 0;
+        std::fclose(fp);
+    }
+    return static_cast<size_t>(resident) * static_cast<size_t>(sysconf(_SC_PAGESIZE)) / (1024 * 1024);
+}
+
+static void burst(const Logger::ptr &lp, size_t bytes)
+{
+    const std::string msg(199, 'x');
+    g_open.store(false);
+    for (size_t n = 0; n < bytes; n += 200)
+        LOG_INFO(lp, "%s", msg.c_str());
+    g_open.store(true);
+    std::this_thread::sleep_for(std::chrono::milliseconds(100)); // 等后台写完
+}
+
+static Logger::ptr makeLogger(const std::string &name, size_t low_streak, std::chrono::milliseconds idle)
+{
+    LocalLoggerBuilder builder;
+    builder.buildLoggerName(name);
+    builder.buildLoggerFormatter("%m%n");
+    builder.buildLoggerType(LoggerType::LOGGER_ASYNC);
+    builder.buildLoggerSink<GateSink>();
+    builder.buildAsyncBufferShrink(64 * 1024, low_streak, idle);
+    return builder.build();
+}
+
+int main()
+{
+    const size_t base = rssMB();
+    std::cout << "初始 RSS: " << base << "MB\n";
+
+    // 1.空闲收缩：突发之后空闲 200ms，两块缓冲区都应缩回初始容量
+    {
+        Logger::ptr lp = makeLogger("shrink_idle", 0, std::chrono::milliseconds(200));
+        std::cout << "创建后 RSS: " << rssMB() << "MB（初始分配很小）\n";
+        burst(lp, 64 * 1024 * 1024);
+        std::cout << "突发 64MB 后 RSS: " << rssMB() << "MB\n";
+        std::this_thread::sleep_for(std::chrono::milliseconds(600));
+        std::cout << "空闲 600ms 后 RSS: " << rssMB() << "MB\n";
+    }
+
+    // 2.低水位收缩：突发之后持续少量写入，连续 8 批低水位后收缩
+    {
+        Logger::ptr lp = makeLogger("shrink_low", 8, std::chrono::milliseconds(0));
+        burst(lp, 64 * 1024 * 1024);
+        std::cout << "突发 64MB 后 RSS: " << rssMB() << "MB\n";
+        for (int i = 0; i < 40; i++)
+        {
+            LOG_INFO(lp, "trickle %d", i);
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        std::cout << "少量写入 40 批后 RSS: " << rssMB() << "MB\n";
+    }
+
+    // 3.多缓冲池：突发时用到几十块 1MB 缓冲区。后台处理积压的这几十批期间没有空闲、批次也不低，
+    //   原来要等空闲或低水位才释放；现在连续 8 批都没用到的空闲块随即释放，之后持续写入也只留轮换所需的几块
+    {
+        LocalLoggerBuilder builder;
+        builder.buildLoggerName("shrink_pool");
+        builder.buildLoggerFormatter("%m%n");
+        builder.buildLoggerType(LoggerType::LOGGER_ASYNC);
+        builder.buildLoggerSink<GateSink>();
+        builder.buildAsyncBufferShrink(64 * 1024, 8, std::chrono::milliseconds(0));
+        builder.buildAsyncBufferPool(1024 * 1024, 64 * 1024 * 1024);
+        Logger::ptr lp = builder.build();
+        burst(lp, 48 * 1024 * 1024);
+        std::cout << "池模式突发 48MB 后 RSS: " << rssMB() << "MB\n";
+        const std::string msg(199, 'y');
+        for (int i = 0; i < 40; i++)
+        {
+            for (int k = 0; k < 1500; k++)
+                LOG_INFO(lp, "%s", msg.c_str());
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        std::cout << "池模式持续写入 40 批后 RSS: " << rssMB() << "MB\n";
+    }
+    return 0;
+}
@@ -0,0 +1,83 @@
+#include "logs/mylog.h"
+
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace mylog;
+
+// 只实现 log() 的旧式落地：靠默认的 logBatch 逐条转交，每次调用都应恰好是一条完整记录
+class LineSink : public LogSink
+{
+public:
+    virtual void log(const char *data, size_t len) override
+    {
+        if (len == 0 || data[len - 1] != '\n' || std::string(data, len - 1).find('\n') != std::string::npos)
+            _broken++;
+        _count++;
+    }
+    size_t _count = 0;
+    size_t _broken = 0;
+};
+
+// 统计 logBatch 的调用次数
+class CountingFileSink : public FileSink
+{
+public:
+    using FileSink::FileSink;
+    virtual void logBatch(const char *data, size_t len, const SinkRecord *records, size_t count) override
+    {
+        _batches++;
+        _records += count;
+        FileSink::logBatch(data, len, records, count);
+    }
+    size_t _batches = 0;
+    size_t _records = 0;
+};
+
+int main()
+{
+    const int count = 100000;
+    const std::string dir = "./logfile/batch";
+    std::filesystem::remove_all(dir);
+
+    auto line_sink = std::make_shared<LineSink>();
+    auto file_sink = std::make_shared<CountingFileSink>(dir + "/file.log");
+    LogSink::ptr roll_sink = SinkFactory<RollBySizeSink>::create(dir + "/roll", 64 * 1024);
+    for (bool deferred : {false, true})
+    {
+        std::vector<LogSink::ptr> sinks{line_sink, file_sink, roll_sink};
+        AsyncOptions opts;
+        opts.deferred = deferred;
+        Logger::ptr lp = std::make_shared<AsyncLogger>("batch", LogLevel::value::DEBUG,
+                                                       std::make_shared<Formatter>("[%p] %m%n"), sinks, opts);
+        for (int i = 0; i < count; i++)
+            LOG_INFO(lp, "batch record %d", i);
+    }
+
+    std::cout << "写入: " << 2 * count << " 条\n";
+    std::cout << "默认适配（逐条）: " << line_sink->_count << " 条, 不完整: " << line_sink->_broken << " 条\n";
+    std::cout << "FileSink: " << file_sink->_records << " 条, logBatch 调用 " << file_sink->_batches << " 次\n";
+
+    // 滚动文件只在记录边界处切分：每个文件都以换行结尾，且不超过上限
+    size_t files = 0, bad = 0, lines = 0;
+    for (auto &entry : std::filesystem::directory_iterator(dir))
+    {
+        if (entry.path().filename().string().rfind("roll", 0) != 0)
+            continue;
+        std::ifstream ifs(entry.path(), std::ios::binary);
+        std::stringstream ss;
+        ss << ifs.rdbuf();
+        const std::string text = ss.str();
+        files++;
+        if (text.empty() || text.back() != '\n' || text.size() > 64 * 1024)
+            bad++;
+        for (char c : text)
+            lines += (c == '\n');
+    }
+    std::cout << "RollBySizeSink: " << files << " 个文件, " << lines << " 条, 越界/截断文件: " << bad << " 个\n";
+    return 0;
+}
@@ -0,0 +1,35 @@
+#include "logs/mylog.h"
+
+#include <iostream>
+#include <string>
+
+// 编译期模式串：必须是静态存储期的字符数组
+static constexpr char kPattern[] = "[%d{%Y-%m-%d %H:%M:%S.%3N}][%t][%c][%f:%l][%p]%T100%%%m%n";
+
+int main()
+{
+    using namespace mylog;
+
+    std::string logger = "root";
+    std::string file = "test_static_formatter.cpp";
+    LogMsg msg(logger, file, 123, std::string("hello-static"), LogLevel::value::INFO);
+    msg.setCtime(1700000000);
+
+    // 与运行期解析的 Formatter 输出应完全一致
+    StaticFormatter<kPattern> f_static;
+    Formatter f_runtime(kPattern);
+    std::string out1 = f_static.format(msg);
+    std::string out2 = f_runtime.format(msg);
+    std::cout << "static  : " << out1;
+    std::cout << "runtime : " << out2;
+    std::cout << (out1 == out2 ? "一致" : "不一致") << "\n";
+
+    // 通过建造者使用；把 kPattern 换成 "%q" 之类的未知键会在编译期报错
+    std::unique_ptr<LoggerBuilder> builder(new LocalLoggerBuilder());
+    builder->buildLoggerName("static_fmt");
+    builder->buildLoggerFormatter<kPattern>();
+    builder->buildLoggerSink<StdoutSink>();
+    Logger::ptr lp = builder->build();
+    LOG_INFO(lp, "via builder %d", 1);
+    return 0;
+}
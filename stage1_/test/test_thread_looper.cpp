@@ -0,0 +1,77 @@
+#include "logs/mylog.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace mylog;
+
+// 统计条数，并检查同一线程的序号是否连续、全局时间戳是否单调
+class CheckSink : public LogSink
+{
+public:
+    virtual void log(const char *data, size_t len) override
+    {
+        std::string line(data, len);
+        unsigned long long ts = std::strtoull(line.c_str(), nullptr, 10);
+        int thr = 0, seq = 0;
+        std::sscanf(std::strchr(line.c_str(), '#'), "#%d %d", &thr, &seq);
+        auto it = _last.find(thr);
+        if (it != _last.end() && it->second + 1 != seq)
+            _in_order = false;
+        _last[thr] = seq;
+        if (ts < _last_ts)
+            _ts_inversions++;
+        _last_ts = ts;
+        _count++;
+    }
+    size_t _count = 0;
+    size_t _ts_inversions = 0;
+    bool _in_order = true;
+
+private:
+    std::map<int, int> _last;
+    unsigned long long _last_ts = 0;
+};
+
+int main()
+{
+    auto sink = std::make_shared<CheckSink>();
+    const int rounds = 4, threads = 8, per_thread = 20000;
+    {
+        // 用自定义 sink 做校验，直接构造异步日志器
+        std::vector<LogSink::ptr> sinks{sink};
+        AsyncOptions opts;
+        opts.looper = LooperType::LOOPER_PER_THREAD;
+        opts.ring_size = 64 * 1024;
+        Logger::ptr lp = std::make_shared<AsyncLogger>("thread_looper", LogLevel::value::DEBUG,
+                                                       std::make_shared<Formatter>("%d{%s%9N} %m%n"), sinks, opts);
+
+        // 每一轮都起一批新线程，写完即退出：退出线程的队列里的记录不能丢
+        for (int r = 0; r < rounds; r++)
+        {
+            std::vector<std::thread> ths;
+            for (int t = 0; t < threads; t++)
+            {
+                int id = r * threads + t;
+                ths.emplace_back([&, id]
+                                 {
+                    for (int i = 0; i < per_thread; i++)
+                        LOG_INFO(lp, "#%d %d", id, i); });
+            }
+            for (auto &th : ths)
+                th.join();
+        }
+    } // 日志器析构：后台线程取空所有队列后退出
+
+    std::cout << "写入: " << rounds * threads * per_thread << " 条, 落地: " << sink->_count << " 条\n";
+    std::cout << "线程内顺序: " << (sink->_in_order ? "正确" : "错误") << "\n";
+    // 归并键就是 %d 打印的 LogMsg 时间戳，并且只交出低水位之前的记录，落地顺序必须全局单调
+    std::cout << "时间戳逆序次数: " << sink->_ts_inversions << "\n";
+    bool ok = sink->_count == size_t(rounds * threads * per_thread) && sink->_in_order && sink->_ts_inversions == 0;
+    return ok ? 0 : 1;
+}
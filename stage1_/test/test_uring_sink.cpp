@@ -0,0 +1,95 @@
+#include "logs/mylog.h"
+#include "logs/uring_sink.hpp"
+
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace mylog;
+
+static std::string readAll(const std::string &path)
+{
+    std::ifstream ifs(path, std::ios::binary);
+    std::ostringstream oss;
+    oss << ifs.rdbuf();
+    return oss.str();
+}
+
+// 与 FileSink 写出同样的内容，结果必须逐字节一致；文件里原有的内容保留在前面
+static void checkSameAsFileSink(size_t buffer_size, size_t depth)
+{
+    const std::string ref_path = "./logfile/uring_ref.log";
+    const std::string path = "./logfile/uring_" + std::to_string(buffer_size) + "_" + std::to_string(depth) + ".log";
+    std::remove(ref_path.c_str());
+    std::remove(path.c_str());
+    {
+        std::ofstream(path) << "existing line\n";
+        std::ofstream(ref_path) << "existing line\n";
+    }
+    bool uring = false;
+    {
+        FileSink ref(ref_path);
+        UringFileSink sink(path, buffer_size, depth);
+        uring = sink.usingUring();
+        for (int i = 0; i < 5000; i++)
+        {
+            std::string line = std::to_string(i) + ":" + std::string((i * 131) % 9000, 'a' + i % 26) + "\n";
+            ref.log(line.data(), line.size());
+            sink.log(line.data(), line.size());
+            if (i == 2500)
+            {
+                ref.flush();
+                sink.flush(); // 中途刷新一次，之后的写入接在后面
+            }
+        }
+        std::string batch(3 * buffer_size + 123, 'b');
+        std::vector<SinkRecord> records{{batch.size(), LogLevel::value::INFO, 0}};
+        ref.logBatch(batch.data(), batch.size(), records.data(), records.size());
+        sink.logBatch(batch.data(), batch.size(), records.data(), records.size());
+    }
+    std::string expect = readAll(ref_path), got = readAll(path);
+    std::cout << "缓冲 " << buffer_size << " 字节 x " << depth << " 块 (" << (uring ? "io_uring" : "同步 pwrite")
+              << "): 写入 " << expect.size() << " 字节, 内容" << (expect == got ? "一致" : "不一致") << "\n";
+}
+
+int main()
+{
+    checkSameAsFileSink(4096, 2);
+    checkSameAsFileSink(64 * 1024, 4);
+    checkSameAsFileSink(DEFAULT_URING_BUFFER_SIZE, 8);
+
+    // 挂到异步日志器上，flush() 之后数据已在文件里
+    {
+        const std::string path = "./logfile/uring_logger.log";
+        std::remove(path.c_str());
+        LocalLoggerBuilder builder;
+        builder.buildLoggerName("uring_sink");
+        builder.buildLoggerFormatter("%m%n");
+        builder.buildLoggerType(LoggerType::LOGGER_ASYNC);
+        builder.buildLoggerSink<UringFileSink>(path);
+        Logger::ptr lp = builder.build();
+        for (int i = 0; i < 100000; i++)
+            LOG_INFO(lp, "line %d", i);
+        lp->flush();
+        size_t lines = 0;
+        for (char c : readAll(path))
+            lines += c == '\n';
+        std::cout << "异步日志器: 写入 100000 条, flush() 后文件中 " << lines << " 条\n";
+    }
+
+    // 写失败不 assert：/dev/full 的写入在完成时报 ENOSPC
+    {
+        UringFileSink full("/dev/full", 4096, 2);
+        std::string data(10000, 'x');
+        full.append(data.data(), data.size());
+        full.flush();
+        std::cout << "/dev/full: 最近错误 " << std::strerror(full.lastError()) << ", 累计失败 " << full.errorCount() << " 次\n";
+        UringFileSink missing("/proc/no_such_dir/x.log");
+        int err = missing.append("x\n", 2);
+        std::cout << "无法创建的路径: 打开" << (missing.isOpen() ? "成功" : "失败") << ", append 返回 "
+                  << std::strerror(err) << "\n";
+    }
+    return 0;
+}